@@ -0,0 +1,145 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "channel-activity-hop-policy.h"
+
+namespace ns3 {
+
+namespace {
+
+// scores below this are treated as no activity
+const float SCORE_FLOOR = 1e-3f;
+
+inline uint32_t
+LowestBit (uint64_t bits)
+{
+  return __builtin_ctzll (bits);
+}
+
+} // anonymous namespace
+
+const uint32_t ChannelActivityHopPolicy::MAX_CHANNELS;
+
+ChannelActivityHopPolicy::ChannelActivityHopPolicy ()
+  : m_enabled (false),
+    m_decay (0.5f)
+{
+  Reset ();
+}
+
+void
+ChannelActivityHopPolicy::SetEnabled (bool enabled)
+{
+  m_enabled = enabled;
+}
+
+bool
+ChannelActivityHopPolicy::IsEnabled (void) const
+{
+  return m_enabled;
+}
+
+void
+ChannelActivityHopPolicy::SetDecay (double decay)
+{
+  m_decay = decay;
+}
+
+double
+ChannelActivityHopPolicy::GetDecay (void) const
+{
+  return m_decay;
+}
+
+void
+ChannelActivityHopPolicy::Reset (void)
+{
+  m_active = 0;
+  m_probed = 0;
+  for (uint32_t i = 0; i < MAX_CHANNELS; i++)
+    {
+      m_score[i] = 0.0f;
+    }
+}
+
+uint16_t
+ChannelActivityHopPolicy::NextChannel (uint16_t currentChannel,
+                                       uint16_t numOfChannels)
+{
+  if (!m_enabled || numOfChannels > MAX_CHANNELS ||
+      currentChannel >= MAX_CHANNELS)
+    {
+      uint16_t nextChannel = currentChannel + 1;
+      if (nextChannel >= numOfChannels)
+        {
+          nextChannel = 1;  // wrap around and start form 1
+        }
+      return nextChannel;
+    }
+
+  // usable channels are 1 .. numOfChannels - 1
+  uint64_t valid = (numOfChannels == MAX_CHANNELS ? ~uint64_t (0)
+                    : (uint64_t (1) << numOfChannels) - 1) & ~uint64_t (1);
+  uint64_t current = uint64_t (1) << currentChannel;
+  m_probed |= current;
+  if ((valid & ~m_probed) == 0)
+    {
+      m_probed = current; // every channel probed, start a new round
+    }
+  uint64_t unprobed = valid & ~m_probed;
+  if (unprobed == 0)
+    {
+      return currentChannel; // only one usable channel
+    }
+
+  uint16_t nextChannel;
+  uint64_t candidates = m_active & unprobed;
+  if (candidates != 0)
+    {
+      // most active unprobed channel
+      nextChannel = LowestBit (candidates);
+      for (uint64_t bits = candidates & (candidates - 1); bits != 0;
+           bits &= bits - 1)
+        {
+          uint32_t channel = LowestBit (bits);
+          if (m_score[channel] > m_score[nextChannel])
+            {
+              nextChannel = channel;
+            }
+        }
+    }
+  else
+    {
+      // sweep: next unprobed channel above the current one, wrapping around
+      uint64_t above = unprobed & ~((current << 1) - 1);
+      nextChannel = LowestBit (above != 0 ? above : unprobed);
+    }
+
+  // age the scores, dropping channels whose activity has faded
+  for (uint64_t bits = m_active; bits != 0; bits &= bits - 1)
+    {
+      uint32_t channel = LowestBit (bits);
+      m_score[channel] *= m_decay;
+      if (m_score[channel] < SCORE_FLOOR)
+        {
+          m_score[channel] = 0.0f;
+          m_active &= ~(uint64_t (1) << channel);
+        }
+    }
+  return nextChannel;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHANNEL_ACTIVITY_HOP_POLICY_H
+#define CHANNEL_ACTIVITY_HOP_POLICY_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Hop policy that chases the victim using where traffic was seen.
+ *
+ * Keeps a decaying activity score per channel, bumped on every packet the
+ * jammer receives, and a bitmap of channels with a live score. On an RX
+ * timeout it hops straight to the most active channel it has not yet probed
+ * since its last packet. With no such channel it sweeps the unprobed
+ * channels in order, so every channel is still visited within
+ * numOfChannels - 1 hops. Channels up to MAX_CHANNELS - 1 are tracked;
+ * beyond that, and while disabled, it steps to the next channel like
+ * NextChannelHopPolicy.
+ */
+class ChannelActivityHopPolicy
+{
+public:
+  static const uint32_t MAX_CHANNELS = 64;
+
+  ChannelActivityHopPolicy ();
+
+  /**
+   * \param enabled True to chase activity, false to step to next channel.
+   */
+  void SetEnabled (bool enabled);
+  bool IsEnabled (void) const;
+
+  /**
+   * \param decay Factor applied to all activity scores on each hop, in
+   * (0, 1).
+   */
+  void SetDecay (double decay);
+  double GetDecay (void) const;
+
+  /**
+   * \returns True if received packets should be reported.
+   */
+  inline bool IsTrackingRx (void) const
+  {
+    return m_enabled;
+  }
+
+  /**
+   * \brief Records a packet received on a channel.
+   *
+   * \param channel Channel the packet was received on.
+   */
+  inline void NotifyRxChannel (uint16_t channel)
+  {
+    if (channel < MAX_CHANNELS)
+      {
+        m_score[channel] += 1.0f;
+        m_active |= uint64_t (1) << channel;
+        m_probed = 0; // the victim was found, start probing afresh
+      }
+  }
+
+  /**
+   * \param currentChannel Channel the jammer is on.
+   * \param numOfChannels Number of channels of the PHY.
+   * \returns Channel to hop to.
+   */
+  uint16_t NextChannel (uint16_t currentChannel, uint16_t numOfChannels);
+
+  /**
+   * Forgets all recorded activity.
+   */
+  void Reset (void);
+
+private:
+  bool m_enabled;
+  float m_decay;
+  uint64_t m_active;    // channels with a live activity score
+  uint64_t m_probed;    // channels visited since the last received packet
+  float m_score[MAX_CHANNELS];
+};
+
+} // namespace ns3
+
+#endif /* CHANNEL_ACTIVITY_HOP_POLICY_H */
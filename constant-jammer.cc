@@ -19,6 +19,7 @@
  */
  
 #include "constant-jammer.h"
+#include "jammer-trace.h"
 #include "ns3/simulator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
@@ -71,13 +72,33 @@ ConstantJammer::GetTypeId (void)
                    MakeUintegerAccessor (&ConstantJammer::SetReactToMitigation,
                                          &ConstantJammer::GetReactToMitigation),
                    MakeUintegerChecker<bool> ())
+    .AddAttribute ("ConstantJammerActivityHopping",
+                   "Constant jammer activity hopping flag, set to hop to the channels where"
+                   " traffic was last seen instead of the next channel.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&ConstantJammer::SetActivityHopping,
+                                         &ConstantJammer::GetActivityHopping),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("ConstantJammerContinuousEmission",
+                   "Constant jammer continuous emission flag, set to send one long"
+                   " emission between channel hops instead of periodic bursts.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&ConstantJammer::SetContinuousEmission,
+                                         &ConstantJammer::GetContinuousEmission),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("ConstantJammerMaxEmissionDuration",
+                   "Longest emission segment in continuous emission mode.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&ConstantJammer::SetMaxEmissionDuration,
+                                     &ConstantJammer::GetMaxEmissionDuration),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
 
 ConstantJammer::ConstantJammer ()
-  :  m_reactToMitigation (false),
-     m_reacting (false)
+  :  m_continuousEmission (false),
+     m_emitting (false)
 {
 }
 
@@ -172,6 +193,66 @@ ConstantJammer::GetReactToMitigation (void) const
   return m_reactToMitigation;
 }
 
+void
+ConstantJammer::SetActivityHopping (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_hopPolicy.SetEnabled (flag);
+}
+
+bool
+ConstantJammer::GetActivityHopping (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_hopPolicy.IsEnabled ();
+}
+
+JammerStats
+ConstantJammer::GetStats (void) const
+{
+  NS_LOG_FUNCTION (this);
+  JammerStats stats = m_stats;
+  stats.node = GetId ();
+  stats.jammerType = CONSTANT_JAMMER;
+  return stats;
+}
+
+void
+ConstantJammer::ResetStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stats.Reset ();
+}
+
+void
+ConstantJammer::SetContinuousEmission (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_continuousEmission = flag;
+}
+
+bool
+ConstantJammer::GetContinuousEmission (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_continuousEmission;
+}
+
+void
+ConstantJammer::SetMaxEmissionDuration (Time duration)
+{
+  NS_LOG_FUNCTION (this << duration);
+  NS_ASSERT (duration.IsStrictlyPositive ());
+  m_maxEmissionDuration = duration;
+}
+
+Time
+ConstantJammer::GetMaxEmissionDuration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_maxEmissionDuration;
+}
+
 /*
  * Private functions start here.
  */
@@ -180,14 +261,14 @@ void
 ConstantJammer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
 ConstantJammer::DoStopJammer (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
@@ -198,42 +279,38 @@ ConstantJammer::DoJamming (void)
 
   if (!IsJammerOn ()) // check if jammer is on
     {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () << ", Jammer is OFF!");
+      JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_JAMMER_OFF, GetId (), 0, 0.0);
       return;
     }
 
-  NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                ", Sending jamming signal with TX power = " << m_txPower <<
-                " W" << ", At " << Simulator::Now ().GetSeconds () << "s");
+  /*
+   * Schedule *first* RX timeout if react to mitigation is enabled. We know if
+   * react to jamming mitigation is enabled, there should always be a RX timeout
+   * event scheduled. Scheduled before sending, so that a continuous emission
+   * segment can end at the first channel hop.
+   */
+  StartRxTimeout ();
 
   // send jamming signal
-  double actualPower = m_utility->SendJammingSignal (m_txPower, m_jammingDuration);
+  Time duration = GetEmissionDuration ();
+  double actualPower = m_utility->SendJammingSignal (m_txPower, duration);
   if (actualPower != 0.0)
     {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", Jamming signal sent with power = " << actualPower << " W");
+      m_emitting = true;
+      m_stats.burstsSent++;
+      m_stats.energy += actualPower * duration.GetSeconds ();
+      JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_BURST_SENT, GetId (), 0,
+                    actualPower);
     }
   else
     {
+      JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_BURST_FAILED, GetId (), 0,
+                    m_txPower);
+      m_stats.burstsFailed++;
       NS_LOG_ERROR ("ConstantJammer:At Node #" << GetId () <<
                     ", Failed to send jamming signal!");
     }
 
-  /*
-   * Schedule *first* RX timeout if react to mitigation is enabled. We know if
-   * react to jamming mitigation is enabled, there should always be a RX timeout
-   * event scheduled. The RX timeout event can only "expire" if it's never been
-   * scheduled.
-   */
-  if (m_reactToMitigation && m_rxTimeoutEvent.IsExpired())
-    {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", After jammer starts, scheduling RX timeout!");
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &ConstantJammer::RxTimeoutHandler,
-                                              this);
-    }
-
   m_reacting = false; // always reset reacting flag
 }
 
@@ -241,23 +318,9 @@ bool
 ConstantJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
 {
   NS_LOG_FUNCTION (this << packet << startRss);
+  JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_RX_START, GetId (), 0, startRss);
 
-  if (m_reactToMitigation)  // check if react to mitigation is enabled
-    {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", React to mitigation enabled! Rescheduling RX Timeout");
-      // cancel RX timeout event
-      m_rxTimeoutEvent.Cancel ();
-      // reschedule next RX timeout
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &ConstantJammer::RxTimeoutHandler,
-                                              this);
-    }
-  else
-    {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", React to mitigation disabled!");
-    }
+  NotifyRxActivity ();
   return false;
 }
 
@@ -265,8 +328,7 @@ bool
 ConstantJammer::DoEndRxHandler (Ptr<Packet> packet, double averageRss)
 {
   NS_LOG_FUNCTION (this << packet);
-  NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                ", Ignoring incoming packet!");
+  JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_RX_END, GetId (), 0, averageRss);
   return false;
 }
 
@@ -274,73 +336,71 @@ void
 ConstantJammer::DoEndTxHandler (Ptr<Packet> packet, double txPower)
 {
   NS_LOG_FUNCTION (this << packet << txPower);
-  NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                ". Sent jamming burst with power = " << txPower);
+  JAMMER_TRACE (CONSTANT_JAMMER, JAMMER_TRACE_BURST_END, GetId (), 0, txPower);
 
-  m_jammingEvent.Cancel (); // cancel previously scheduled event
+  m_emitting = false;
+  m_stats.Cancel (m_jammingEvent); // cancel previously scheduled event
 
   // check to see if we are waiting the jammer to finish reacting to mitigation
-  if (m_reacting)
+  if (DeferJammingForChannelSwitch ())
     {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", Not sending jamming signal, jammer reacting to mitigation!");
-      // get channel switch delay
-      Time delay = m_utility->GetPhyLayerInfo().channelSwitchDelay;
-      // schedule next jamming burst after channel switch delay
-      m_jammingEvent = Simulator::Schedule (delay,
-                                            &ConstantJammer::DoJamming,
-                                            this);
       return;
     }
 
   // schedule next jamming burst after jamming interval.
-  m_jammingEvent = Simulator::Schedule (m_constantJammingInterval,
+  m_jammingEvent = Simulator::Schedule (m_continuousEmission ? Seconds (0.0)
+                                        : m_constantJammingInterval,
                                         &ConstantJammer::DoJamming, this);
+  m_stats.eventsScheduled++;
 }
 
 void
-ConstantJammer::RxTimeoutHandler (void)
+ConstantJammer::OnChannelHop (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () << ", RX timeout at " <<
-                Simulator::Now ().GetSeconds () << "s");
-  NS_ASSERT (m_utility != NULL);
-
-  if (!m_reactToMitigation) // check react to mitigation flag
+  /*
+   * A continuous emission segment ends when the RX timeout expires. If it
+   * ended just before the hop, the next segment is already scheduled for
+   * now, on the new channel; hold it back for the channel switch delay.
+   */
+  if (m_continuousEmission && !m_emitting && m_jammingEvent.IsRunning ())
     {
-      NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                    ", React to mitigation is turned OFF!");
-      return;
+      m_stats.Cancel (m_jammingEvent);
+      m_jammingEvent = Simulator::Schedule (m_utility->GetPhyLayerInfo ().channelSwitchDelay,
+                                            &ConstantJammer::DoJamming,
+                                            this);
+      m_stats.eventsScheduled++;
     }
+}
 
-  // Calculate channel number.
-  uint16_t currentChannel = m_utility->GetPhyLayerInfo ().currentChannel;
-  uint16_t nextChannel = currentChannel + 1;
-  if (nextChannel >= m_utility->GetPhyLayerInfo ().numOfChannels)
+Time
+ConstantJammer::GetEmissionDuration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_continuousEmission)
     {
-      nextChannel = 1;  // wrap around and start form 1
+      return m_jammingDuration;
     }
-
-  NS_LOG_DEBUG ("ConstantJammer:At Node #" << GetId () <<
-                ", Switching from channel " << currentChannel << " >-> " <<
-                nextChannel << ", At " << Simulator::Now ().GetSeconds () << "s");
-
-  // hop to next channel
-  m_utility->SwitchChannel (nextChannel);
-
   /*
-   * Set reacting flag to indicate jammer is reacting. When the flag is set, no
-   * scheduling of new jamming event is allowed.
+   * End the segment when the next RX timeout expires, where the jammer may
+   * hop. On the JammerTimerWheel that is the first tick at or after the
+   * deadline, not the deadline itself. Packets received meanwhile only push
+   * the timeout later, so the segment never runs past a hop; it at worst
+   * ends early and the next segment picks up.
    */
-  m_reacting = true;
-
-  // cancel previously scheduled RX timeout
-  m_rxTimeoutEvent.Cancel ();
-
-  // schedule next RX timeout
-  m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                          &ConstantJammer::RxTimeoutHandler,
-                                          this);
+  Time duration = m_maxEmissionDuration;
+  if (m_reactToMitigation && m_rxTimeoutTimer.IsRunning ())
+    {
+      Time untilTimeout = JammerTimerWheel::GetExpiryTime (m_rxTimeoutDeadline)
+        - Simulator::Now ();
+      if (untilTimeout < duration)
+        {
+          // a timeout due right now gets a normal burst before the hop
+          duration = untilTimeout.IsStrictlyPositive () ? untilTimeout
+            : m_jammingDuration;
+        }
+    }
+  return duration;
 }
 
 } // namespace ns3
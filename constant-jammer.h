@@ -22,6 +22,9 @@
 #define CONSTANTJAMMER_H
 
 #include "jammer.h"
+#include "jammer-stats.h"
+#include "jammer-mitigation.h"
+#include "channel-activity-hop-policy.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
@@ -30,9 +33,11 @@ namespace ns3 {
 /**
  * Constant Jammer.
  */
-class ConstantJammer : public Jammer
+class ConstantJammer : public Jammer, public JammerMitigation<ConstantJammer, ChannelActivityHopPolicy>
 {
 public:
+  static const JammerType JAMMER_TYPE = CONSTANT_JAMMER;
+
   static TypeId GetTypeId (void);
   ConstantJammer ();
   virtual ~ConstantJammer ();
@@ -69,9 +74,38 @@ public:
   Time GetRxTimeout (void) const;
   void SetReactToMitigation (const bool flag);
   bool GetReactToMitigation (void) const;
-  
+  /**
+   * \brief Enables activity-based channel hopping.
+   *
+   * \param flag True to hop to the channels where traffic was last seen, see
+   * ChannelActivityHopPolicy, instead of stepping to the next channel.
+   */
+  void SetActivityHopping (const bool flag);
+  bool GetActivityHopping (void) const;
+
+  /**
+   * \returns Work counters of this jammer since start or the last reset.
+   */
+  JammerStats GetStats (void) const;
+  void ResetStats (void);
+  /**
+   * \brief Enables continuous emission.
+   *
+   * \param flag True to model the jamming signal as one long emission.
+   *
+   * In continuous mode the jammer sends emission segments back to back,
+   * each lasting until the next RX timeout (channel hop) or for at most the
+   * maximum emission duration, instead of one JammingDuration burst per
+   * event. The constant jamming interval is ignored.
+   */
+  void SetContinuousEmission (const bool flag);
+  bool GetContinuousEmission (void) const;
+  void SetMaxEmissionDuration (Time duration);
+  Time GetMaxEmissionDuration (void) const;
 
 private:
+  friend class JammerMitigation<ConstantJammer, ChannelActivityHopPolicy>;
+
   void DoDispose (void);
 
   /**
@@ -114,9 +148,14 @@ private:
   virtual void DoEndTxHandler (Ptr<Packet> packet, double txPower);
 
   /**
-   * Handles RX timeout event by hopping onto next channel.
+   * Called by JammerMitigation after each channel hop.
+   */
+  void OnChannelHop (void);
+
+  /**
+   * \returns Duration of the next jamming signal.
    */
-  void RxTimeoutHandler (void);
+  Time GetEmissionDuration (void) const;
 
 private:
   Ptr<WirelessModuleUtility> m_utility; // pointer to utility
@@ -125,10 +164,10 @@ private:
   double m_txPower;                     // TX power
   Time m_jammingDuration;               // jamming duration
   EventId m_jammingEvent;               // jamming event
-  Time m_rxTimeout;                     // RX timeout interval
-  EventId m_rxTimeoutEvent;             // RX timeout event
-  bool m_reactToMitigation;   // true if jammer is reacting to mitigation
-  bool m_reacting;    // flag indicating jammer is reacting to mitigation
+  JammerStats m_stats;                  // work counters
+  bool m_continuousEmission;            // true if in continuous mode
+  Time m_maxEmissionDuration;           // longest continuous segment
+  bool m_emitting;    // true while a jamming signal is on the air
 
 };
 
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Exports models trained in classification.ipynb to the jamming-model text
+format read by the C++ classifiers (see tree-ensemble-model.h).
+
+From the notebook:
+
+    import importlib
+    export = importlib.import_module("export-jamming-model")
+    export.export_forest(rf, "forest.model")     # RandomForestClassifier
+    export.export_forest(clf, "tree.model")      # DecisionTreeClassifier
+    export.export_boosting(gradient_boosting_classifier, "boosting.model")
+    export.export_predictions(classifier, test_data, "expected.txt")
+
+jamming-model-codegen turns any of these into a header of inline code.
+jamming-classify --expected=expected.txt checks a C++ classifier against the
+predictions of the notebook's model on the same input.
+"""
+
+import numpy as np
+
+
+def _check_classes(model):
+    classes = np.asarray(model.classes_)
+    if not np.array_equal(classes, np.arange(len(classes))):
+        raise ValueError("classes must be 0 .. n-1, got %s" % classes)
+    return len(classes)
+
+
+def _write_tree(f, index, tree, leaf_values):
+    f.write("tree %d %d\n" % (index, tree.node_count))
+    for n in range(tree.node_count):
+        if tree.children_left[n] == -1:
+            f.write("-1 " + " ".join(repr(float(v)) for v in leaf_values(n)) +
+                    "\n")
+        else:
+            f.write("%d %r %d %d\n" % (tree.feature[n], float(tree.threshold[n]),
+                                       tree.children_left[n],
+                                       tree.children_right[n]))
+
+
+def export_forest(model, filename):
+    """Writes a RandomForestClassifier or a DecisionTreeClassifier.
+
+    Leaf values are the raw tree_.value rows; the C++ side normalizes them
+    the same way predict_proba does.
+    """
+    classes = _check_classes(model)
+    estimators = getattr(model, "estimators_", [model])
+    with open(filename, "w") as f:
+        f.write("jamming-model 1\nkind forest\n")
+        f.write("classes %d\nfeatures %d\noutputs %d\ntrees %d\n" %
+                (classes, model.n_features_in_, classes, len(estimators)))
+        for i, estimator in enumerate(estimators):
+            tree = estimator.tree_
+            _write_tree(f, i, tree, lambda n, tree=tree: tree.value[n][0])
+
+
+def export_boosting(model, filename):
+    """Writes a GradientBoostingClassifier.
+
+    Leaf values are scaled by the learning rate here, the way
+    predict_stages scales them, and the initial scores are the raw
+    predictions of the init estimator.
+    """
+    classes = _check_classes(model)
+    if model.init_ == "zero":
+        init = np.zeros(model.estimators_.shape[1])
+    else:
+        x = np.zeros((1, model.n_features_in_), dtype=np.float32)
+        init = np.asarray(model._raw_predict_init(x))[0]
+    stages, scores = model.estimators_.shape
+    with open(filename, "w") as f:
+        f.write("jamming-model 1\nkind boosting\n")
+        f.write("classes %d\nfeatures %d\noutputs 1\ntrees %d\n" %
+                (classes, model.n_features_in_, stages * scores))
+        f.write("init " + " ".join(repr(float(v)) for v in init) + "\n")
+        rate = model.learning_rate
+        for i in range(stages):
+            for k in range(scores):
+                tree = model.estimators_[i, k].tree_
+                _write_tree(f, i * scores + k, tree,
+                            lambda n, tree=tree: [rate * tree.value[n][0][0]])
+
+
+def export_predictions(model, features, filename):
+    """Writes the labels a model predicts, one per line, for
+    jamming-classify --expected.
+    """
+    np.savetxt(filename, model.predict(features), fmt="%d")
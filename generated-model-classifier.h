@@ -0,0 +1,59 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GENERATED_MODEL_CLASSIFIER_H
+#define GENERATED_MODEL_CLASSIFIER_H
+
+#include "jamming-classifier.h"
+
+namespace ns3 {
+
+/**
+ * \brief Classifier running a model compiled by jamming-model-codegen.
+ *
+ * Model is the generated struct, its Classify is inlined here:
+ *
+ * \code
+ *   #include "boosting-model.h"
+ *   detector->SetClassifier (Create<GeneratedModelClassifier<BoostingModel> > ());
+ * \endcode
+ */
+template <class Model>
+class GeneratedModelClassifier : public JammingClassifier
+{
+public:
+  virtual ~GeneratedModelClassifier ()
+  {
+  }
+
+  virtual JammerType Classify (const JammingFeature &feature) const
+  {
+    return static_cast<JammerType> (Model::Classify (feature.rss, feature.pdr));
+  }
+
+  virtual void ClassifyBatch (const JammingFeature *features, uint8_t *labels,
+                              uint32_t n) const
+  {
+    for (uint32_t i = 0; i < n; i++)
+      {
+        labels[i] = Model::Classify (features[i].rss, features[i].pdr);
+      }
+  }
+};
+
+} // namespace ns3
+
+#endif /* GENERATED_MODEL_CLASSIFIER_H */
@@ -0,0 +1,310 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gradient-boosting-trainer.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+// feature values closer than this are not split, as in sklearn
+const double FEATURE_THRESHOLD = 1e-7;
+
+/**
+ * Node waiting to be grown: a range of the tree's sorted sample lists.
+ */
+struct PendingNode
+{
+  uint32_t begin;
+  uint32_t end;
+  uint32_t depth;
+  int32_t parent;       // -1 for the root
+  bool isLeft;          // true if the left child of parent
+};
+
+} // anonymous namespace
+
+GradientBoostingTrainer::GradientBoostingTrainer ()
+  : m_stages (100),
+    m_maxDepth (3),
+    m_learningRate (0.1)
+{
+}
+
+void
+GradientBoostingTrainer::SetSamples (const std::vector<JammingSample> &samples)
+{
+  m_columns = Create<TrainingColumns> (samples);
+}
+
+void
+GradientBoostingTrainer::SetColumns (Ptr<TrainingColumns> columns)
+{
+  m_columns = columns;
+}
+
+void
+GradientBoostingTrainer::SetStageCount (uint32_t stages)
+{
+  m_stages = stages;
+}
+
+void
+GradientBoostingTrainer::SetMaxDepth (uint32_t depth)
+{
+  m_maxDepth = depth;
+}
+
+void
+GradientBoostingTrainer::SetLearningRate (double rate)
+{
+  m_learningRate = rate;
+}
+
+void
+GradientBoostingTrainer::Train (TreeEnsembleModel &model) const
+{
+  NS_ASSERT (m_columns != NULL && m_columns->GetClassCount () >= 2);
+  const std::vector<uint8_t> &labels = m_columns->GetLabels ();
+  uint32_t n = labels.size ();
+  uint32_t classes = m_columns->GetClassCount ();
+
+  model.kind = "boosting";
+  model.classes = classes;
+  model.features = TrainingColumns::FEATURES;
+  model.outputs = 1;
+  uint32_t scores = model.GetScoreCount ();
+
+  // initial scores from the clipped class priors
+  const double eps = std::numeric_limits<double>::epsilon ();
+  std::vector<double> prior (classes, 0.0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      prior[labels[i]] += 1.0;
+    }
+  for (uint32_t c = 0; c < classes; c++)
+    {
+      prior[c] = std::min (std::max (prior[c] / n, eps), 1.0 - eps);
+    }
+  model.init.assign (scores, 0.0);
+  if (scores == 1)
+    {
+      model.init[0] = std::log (prior[1] / (1.0 - prior[1]));
+    }
+  else
+    {
+      double mean = 0.0;
+      for (uint32_t c = 0; c < classes; c++)
+        {
+          model.init[c] = std::log (prior[c]);
+          mean += model.init[c];
+        }
+      mean /= classes;
+      for (uint32_t c = 0; c < classes; c++)
+        {
+          model.init[c] -= mean;
+        }
+    }
+
+  std::vector<double> raw (n * scores);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      std::copy (model.init.begin (), model.init.end (), &raw[i * scores]);
+    }
+  double factor = scores == 1 ? 1.0 : double (classes - 1) / classes;
+  std::vector<double> probability (n * scores);
+  std::vector<double> residual (n);
+  std::vector<double> hessian (n);
+  std::vector<int32_t> leafOf (n);
+  model.trees.assign (m_stages * scores, DecisionTree ());
+  for (uint32_t stage = 0; stage < m_stages; stage++)
+    {
+      // all trees of a stage fit the scores as they were before it
+      for (uint32_t i = 0; i < n; i++)
+        {
+          const double *score = &raw[i * scores];
+          double *p = &probability[i * scores];
+          if (scores == 1)
+            {
+              p[0] = 1.0 / (1.0 + std::exp (-score[0]));
+              continue;
+            }
+          double highest = *std::max_element (score, score + scores);
+          double sum = 0.0;
+          for (uint32_t k = 0; k < scores; k++)
+            {
+              p[k] = std::exp (score[k] - highest);
+              sum += p[k];
+            }
+          for (uint32_t k = 0; k < scores; k++)
+            {
+              p[k] /= sum;
+            }
+        }
+      for (uint32_t k = 0; k < scores; k++)
+        {
+          uint32_t target = scores == 1 ? 1 : k;
+          for (uint32_t i = 0; i < n; i++)
+            {
+              double p = probability[i * scores + k];
+              residual[i] = (labels[i] == target ? 1.0 : 0.0) - p;
+              hessian[i] = p * (1.0 - p);
+            }
+          DecisionTree &tree = model.trees[stage * scores + k];
+          GrowTree (residual, hessian, factor, tree, leafOf);
+          for (uint32_t i = 0; i < n; i++)
+            {
+              raw[i * scores + k] += tree.values[leafOf[i]];
+            }
+        }
+    }
+}
+
+void
+GradientBoostingTrainer::GrowTree (const std::vector<double> &residual,
+                                   const std::vector<double> &hessian,
+                                   double factor, DecisionTree &tree,
+                                   std::vector<int32_t> &leafOf) const
+{
+  const uint32_t FEATURES = TrainingColumns::FEATURES;
+  uint32_t n = residual.size ();
+  std::vector<uint32_t> order[FEATURES];
+  for (uint32_t f = 0; f < FEATURES; f++)
+    {
+      order[f] = m_columns->GetSorted (f);
+    }
+  std::vector<uint8_t> goesLeft (n);
+  std::vector<uint32_t> buffer (n);
+
+  tree.nodes.clear ();
+  tree.values.clear ();
+  std::vector<PendingNode> stack;
+  PendingNode root = { 0, n, 0, -1, false };
+  stack.push_back (root);
+  while (!stack.empty ())
+    {
+      // depth first, left child first: nodes come out in sklearn's order
+      PendingNode pending = stack.back ();
+      stack.pop_back ();
+      int32_t node = tree.nodes.size ();
+      tree.nodes.push_back (TreeNode ());
+      tree.values.push_back (0.0);
+      if (pending.parent >= 0)
+        {
+          TreeNode &parent = tree.nodes[pending.parent];
+          (pending.isLeft ? parent.left : parent.right) = node;
+        }
+
+      uint32_t samples = pending.end - pending.begin;
+      double sum = 0.0;
+      double squares = 0.0;
+      for (uint32_t p = pending.begin; p < pending.end; p++)
+        {
+          double r = residual[order[0][p]];
+          sum += r;
+          squares += r * r;
+        }
+      double impurity = squares / samples - (sum / samples) * (sum / samples);
+
+      bool found = false;
+      uint32_t bestFeature = 0;
+      uint32_t bestEnd = 0;
+      double bestThreshold = 0.0;
+      double bestProxy = -std::numeric_limits<double>::infinity ();
+      if (pending.depth < m_maxDepth && samples >= 2 &&
+          impurity > std::numeric_limits<double>::epsilon ())
+        {
+          for (uint32_t f = 0; f < FEATURES; f++)
+            {
+              const std::vector<uint32_t> &sorted = order[f];
+              const std::vector<float> &values = m_columns->GetValues (f);
+              if (values[sorted[pending.end - 1]] <=
+                  values[sorted[pending.begin]] + FEATURE_THRESHOLD)
+                {
+                  continue; // constant in this node
+                }
+              double leftSum = 0.0;
+              for (uint32_t p = pending.begin; p + 1 < pending.end; p++)
+                {
+                  uint32_t sample = sorted[p];
+                  leftSum += residual[sample];
+                  double value = values[sample];
+                  double nextValue = values[sorted[p + 1]];
+                  if (nextValue <= value + FEATURE_THRESHOLD)
+                    {
+                      continue;
+                    }
+                  // Friedman's improvement, up to a constant factor
+                  double left = p + 1 - pending.begin;
+                  double right = samples - left;
+                  double diff = right * leftSum - left * (sum - leftSum);
+                  double proxy = diff * diff / (left * right);
+                  if (proxy > bestProxy)
+                    {
+                      found = true;
+                      bestFeature = f;
+                      bestEnd = p + 1;
+                      bestProxy = proxy;
+                      bestThreshold =
+                        TrainingColumns::Threshold (values[sample],
+                                                    values[sorted[p + 1]]);
+                    }
+                }
+            }
+        }
+
+      TreeNode &current = tree.nodes[node];
+      current.left = -1;
+      current.right = -1;
+      if (!found)
+        {
+          // one Newton step on the leaf's samples
+          double numerator = 0.0;
+          double denominator = 0.0;
+          for (uint32_t p = pending.begin; p < pending.end; p++)
+            {
+              uint32_t sample = order[0][p];
+              numerator += residual[sample];
+              denominator += hessian[sample];
+              leafOf[sample] = node;
+            }
+          numerator *= factor;
+          double value = std::fabs (denominator) < 1e-150 ? 0.0
+            : numerator / denominator;
+          current.feature = -1;
+          current.threshold = 0.0;
+          tree.values[node] = m_learningRate * value;
+          continue;
+        }
+      current.feature = bestFeature;
+      current.threshold = bestThreshold;
+      TrainingColumns::Partition (order, bestFeature, pending.begin, bestEnd,
+                                  pending.end, goesLeft, buffer);
+
+      PendingNode rightChild = { bestEnd, pending.end, pending.depth + 1,
+                                 node, false };
+      PendingNode leftChild = { pending.begin, bestEnd, pending.depth + 1,
+                                node, true };
+      stack.push_back (rightChild);
+      stack.push_back (leftChild);
+    }
+}
+
+} // namespace ns3
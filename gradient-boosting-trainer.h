@@ -0,0 +1,102 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GRADIENT_BOOSTING_TRAINER_H
+#define GRADIENT_BOOSTING_TRAINER_H
+
+#include "training-columns.h"
+#include "tree-ensemble-model.h"
+#include "ns3/ptr.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Gradient boosting trainer over scaled (RSS, PDR) samples, as
+ * sklearn's GradientBoostingClassifier with log loss.
+ *
+ * Scores start from the log of the class priors (log odds for two
+ * classes). Every stage fits one regression tree per score to the
+ * negative gradient, y - p, splitting by Friedman's MSE improvement over
+ * all features, and sets each leaf to one Newton step, sum (y - p) /
+ * sum (p (1 - p)), scaled by (K - 1) / K for K > 2 classes. Leaf values
+ * are multiplied by the learning rate before they are added to the
+ * scores, and are stored that way in the model.
+ *
+ * Splits partition the presorted TrainingColumns as RandomForestTrainer
+ * does; a search over stages, depths and rates shares one TrainingColumns
+ * between its candidates. There is no random draw: trees use all samples
+ * and features.
+ */
+class GradientBoostingTrainer
+{
+public:
+  GradientBoostingTrainer ();
+
+  /**
+   * \brief Sets the training set and sorts its feature columns.
+   */
+  void SetSamples (const std::vector<JammingSample> &samples);
+
+  /**
+   * \brief Sets the training set to already sorted columns.
+   */
+  void SetColumns (Ptr<TrainingColumns> columns);
+
+  /**
+   * \param stages Boosting stages (default 100).
+   */
+  void SetStageCount (uint32_t stages);
+
+  /**
+   * \param depth Deepest leaf of each tree (default 3).
+   */
+  void SetMaxDepth (uint32_t depth);
+
+  /**
+   * \param rate Shrinkage of each stage (default 0.1).
+   */
+  void SetLearningRate (double rate);
+
+  /**
+   * \brief Trains a model of kind "boosting".
+   */
+  void Train (TreeEnsembleModel &model) const;
+
+private:
+  /**
+   * \brief Grows one regression tree on the residuals.
+   *
+   * \param residual y - p of each sample.
+   * \param hessian p (1 - p) of each sample.
+   * \param factor Factor of the Newton step numerator, (K - 1) / K for
+   * K > 2 classes, else 1.
+   * \param tree Filled with the tree, leaf values times the rate.
+   * \param leafOf Filled with the leaf of each sample.
+   */
+  void GrowTree (const std::vector<double> &residual,
+                 const std::vector<double> &hessian, double factor,
+                 DecisionTree &tree, std::vector<int32_t> &leafOf) const;
+
+  uint32_t m_stages;
+  uint32_t m_maxDepth;
+  double m_learningRate;
+  Ptr<TrainingColumns> m_columns;
+};
+
+} // namespace ns3
+
+#endif /* GRADIENT_BOOSTING_TRAINER_H */
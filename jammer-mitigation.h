@@ -0,0 +1,224 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_MITIGATION_H
+#define JAMMER_MITIGATION_H
+
+#include "jammer-timer-wheel.h"
+#include "jammer-trace.h"
+#include "ns3/assert.h"
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/**
+ * \brief Hop policy stepping to the next channel, wrapping around to 1.
+ *
+ * A hop policy provides NextChannel (current, numOfChannels), and
+ * NotifyRxChannel (channel), called on each received packet while
+ * IsTrackingRx () is true.
+ */
+class NextChannelHopPolicy
+{
+public:
+  /**
+   * \param currentChannel Channel the jammer is on.
+   * \param numOfChannels Number of channels of the PHY.
+   * \returns Channel to hop to.
+   */
+  inline uint16_t NextChannel (uint16_t currentChannel, uint16_t numOfChannels)
+  {
+    uint16_t nextChannel = currentChannel + 1;
+    if (nextChannel >= numOfChannels)
+      {
+        nextChannel = 1;  // wrap around and start form 1
+      }
+    return nextChannel;
+  }
+
+  /**
+   * \returns False, received packets are ignored.
+   */
+  inline bool IsTrackingRx (void) const
+  {
+    return false;
+  }
+
+  inline void NotifyRxChannel (uint16_t channel)
+  {
+  }
+};
+
+/**
+ * \brief Reaction to jamming mitigation (channel hopping), shared by the
+ * jammers.
+ *
+ * JammerT derives from JammerMitigation<JammerT, HopPolicy> and befriends
+ * it; the handlers below reach its m_utility, m_stats, m_jammingEvent and
+ * DoJamming directly and call its hooks without virtual dispatch. JammerT
+ * provides JAMMER_TYPE and may hide OnChannelHop to act on a hop. The
+ * HopPolicy picks the channel to hop to.
+ *
+ * When react to mitigation is enabled, the jammer hops channels after
+ * RxTimeout without receiving a packet. The timeout is lazy: received
+ * packets only push m_rxTimeoutDeadline back, and the one pending timer
+ * re-arms itself for the deadline when it fires early. The timer runs on
+ * the JammerTimerWheel when it is enabled.
+ */
+template <class JammerT, class HopPolicy = NextChannelHopPolicy>
+class JammerMitigation
+{
+protected:
+  JammerMitigation ()
+    : m_reactToMitigation (false),
+      m_reacting (false)
+  {
+    m_rxTimeoutTimer.SetFunction (MakeCallback (&JammerMitigation::RxTimeoutHandler,
+                                                this));
+  }
+
+  /**
+   * \brief Schedules the first RX timeout, if react to mitigation is enabled
+   * and none is pending.
+   */
+  inline void StartRxTimeout (void)
+  {
+    if (m_reactToMitigation && !m_rxTimeoutTimer.IsRunning ())
+      {
+        m_rxTimeoutDeadline = Simulator::Now () + m_rxTimeout;
+        ScheduleRxTimeout (m_rxTimeout);
+      }
+  }
+
+  /**
+   * \brief Pushes the RX timeout back on a received packet.
+   */
+  inline void NotifyRxActivity (void)
+  {
+    if (m_reactToMitigation)
+      {
+        if (m_hopPolicy.IsTrackingRx ())
+          {
+            JammerT &self = static_cast<JammerT &> (*this);
+            m_hopPolicy.NotifyRxChannel (self.m_utility->GetPhyLayerInfo ().currentChannel);
+          }
+        m_rxTimeoutDeadline = Simulator::Now () + m_rxTimeout;
+        if (!m_rxTimeoutTimer.IsRunning ())
+          {
+            ScheduleRxTimeout (m_rxTimeout);
+          }
+      }
+  }
+
+  /**
+   * \brief Schedules the next jamming burst after the channel switch delay,
+   * if the jammer is reacting to mitigation.
+   *
+   * \returns True if the jammer is reacting and the burst was scheduled.
+   */
+  inline bool DeferJammingForChannelSwitch (void)
+  {
+    if (!m_reacting)
+      {
+        return false;
+      }
+    JammerT &self = static_cast<JammerT &> (*this);
+    JAMMER_TRACE (JammerT::JAMMER_TYPE, JAMMER_TRACE_REACTING, self.GetId (),
+                  0, 0.0);
+    self.m_jammingEvent =
+      Simulator::Schedule (self.m_utility->GetPhyLayerInfo ().channelSwitchDelay,
+                           &JammerT::DoJamming, &self);
+    self.m_stats.eventsScheduled++;
+    return true;
+  }
+
+  /**
+   * \brief Hook called after each channel hop. Hidden by jammers that need
+   * to act on a hop.
+   */
+  inline void OnChannelHop (void)
+  {
+  }
+
+  /**
+   * Handles RX timeout event by hopping onto the channel picked by the hop
+   * policy.
+   */
+  void RxTimeoutHandler (void)
+  {
+    JammerT &self = static_cast<JammerT &> (*this);
+    NS_ASSERT (self.m_utility != NULL);
+
+    if (Simulator::Now () < m_rxTimeoutDeadline)
+      {
+        // packets were received since this event was scheduled, wait for them
+        ScheduleRxTimeout (m_rxTimeoutDeadline - Simulator::Now ());
+        return;
+      }
+
+    JAMMER_TRACE (JammerT::JAMMER_TYPE, JAMMER_TRACE_RX_TIMEOUT, self.GetId (),
+                  m_reactToMitigation, 0.0);
+
+    if (!m_reactToMitigation)
+      {
+        return; // do nothing if react to mitigation flag is not set
+      }
+
+    uint16_t currentChannel = self.m_utility->GetPhyLayerInfo ().currentChannel;
+    uint16_t nextChannel =
+      m_hopPolicy.NextChannel (currentChannel,
+                               self.m_utility->GetPhyLayerInfo ().numOfChannels);
+
+    JAMMER_TRACE (JammerT::JAMMER_TYPE, JAMMER_TRACE_CHANNEL_HOP, self.GetId (),
+                  uint32_t (currentChannel) << 16 | nextChannel, 0.0);
+    self.m_stats.channelHops++;
+
+    // hop to next channel
+    self.m_utility->SwitchChannel (nextChannel);
+
+    /*
+     * Set reacting flag to indicate jammer is reacting. When the flag is set,
+     * no scheduling of new jamming event is allowed.
+     */
+    m_reacting = true;
+    self.OnChannelHop ();
+
+    // schedule next RX timeout
+    m_rxTimeoutDeadline = Simulator::Now () + m_rxTimeout;
+    ScheduleRxTimeout (m_rxTimeout);
+  }
+
+  Time m_rxTimeout;           // RX timeout interval
+  JammerTimer m_rxTimeoutTimer; // RX timeout timer
+  Time m_rxTimeoutDeadline;   // RX timeout, pushed back by RX
+  bool m_reactToMitigation;   // true if jammer is reacting to mitigation
+  bool m_reacting;    // flag indicating jammer is reacting to mitigation
+  HopPolicy m_hopPolicy;      // picks the channel to hop to
+
+private:
+  inline void ScheduleRxTimeout (Time delay)
+  {
+    m_rxTimeoutTimer.Schedule (delay);
+    static_cast<JammerT &> (*this).m_stats.eventsScheduled++;
+  }
+};
+
+} // namespace ns3
+
+#endif /* JAMMER_MITIGATION_H */
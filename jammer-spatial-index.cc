@@ -0,0 +1,217 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jammer-spatial-index.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+namespace {
+
+// cells per jammer above which Build coarsens the grid
+const uint32_t MAX_CELLS_PER_JAMMER = 64;
+const uint32_t MIN_CELLS = 1024;
+
+} // anonymous namespace
+
+const double JammerSpatialIndex::DEFAULT_REFERENCE_LOSS = 46.6777;
+const double JammerSpatialIndex::DEFAULT_PATH_LOSS_EXPONENT = 3.0;
+const double JammerSpatialIndex::DEFAULT_NOISE_FLOOR = -101.0;
+
+JammerSpatialIndex::JammerSpatialIndex (double cellSize)
+  : m_cellSize (cellSize),
+    m_cell (0.0),
+    m_minX (0.0),
+    m_minY (0.0),
+    m_nx (0),
+    m_ny (0)
+{
+  NS_ASSERT (cellSize >= 0.0);
+}
+
+JammerSpatialIndex::~JammerSpatialIndex ()
+{
+}
+
+double
+JammerSpatialIndex::ComputeReach (double txPower, double noiseFloor,
+                                  double exponent, double referenceLoss)
+{
+  NS_ASSERT (exponent > 0.0);
+  if (txPower <= 0.0)
+    {
+      return 0.0;
+    }
+  double txPowerDbm = 10.0 * std::log10 (1000.0 * txPower);
+  return std::pow (10.0, (txPowerDbm - referenceLoss - noiseFloor) /
+                   (10.0 * exponent));
+}
+
+void
+JammerSpatialIndex::Add (uint32_t id, const Vector &position, double reach)
+{
+  NS_ASSERT (reach >= 0.0);
+  Entry entry;
+  entry.id = id;
+  entry.x = position.x;
+  entry.y = position.y;
+  entry.z = position.z;
+  entry.reach2 = reach * reach;
+  m_entries.push_back (entry);
+}
+
+void
+JammerSpatialIndex::Clear (void)
+{
+  m_entries.clear ();
+  m_cellStart.clear ();
+  m_cellEntries.clear ();
+  m_nx = m_ny = 0;
+}
+
+uint32_t
+JammerSpatialIndex::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+void
+JammerSpatialIndex::Build (void)
+{
+  m_cellStart.clear ();
+  m_cellEntries.clear ();
+  m_nx = m_ny = 0;
+  if (m_entries.empty ())
+    {
+      return;
+    }
+
+  // bounding box of all reach disks
+  double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+  double maxReach = 0.0;
+  for (std::vector<Entry>::const_iterator it = m_entries.begin ();
+       it != m_entries.end (); ++it)
+    {
+      double reach = std::sqrt (it->reach2);
+      minX = std::min (minX, it->x - reach);
+      minY = std::min (minY, it->y - reach);
+      maxX = std::max (maxX, it->x + reach);
+      maxY = std::max (maxY, it->y + reach);
+      maxReach = std::max (maxReach, reach);
+    }
+
+  m_cell = m_cellSize > 0.0 ? m_cellSize : maxReach;
+  if (m_cell <= 0.0)
+    {
+      m_cell = 1.0; // all jammers have zero reach
+    }
+  // sparse jammers over a wide field: coarsen rather than allocate empty cells
+  double maxCells = std::max (double (MIN_CELLS),
+                              double (MAX_CELLS_PER_JAMMER) * m_entries.size ());
+  for (;;)
+    {
+      double nx = std::floor ((maxX - minX) / m_cell) + 1.0;
+      double ny = std::floor ((maxY - minY) / m_cell) + 1.0;
+      if (nx * ny <= maxCells)
+        {
+          m_nx = uint32_t (nx);
+          m_ny = uint32_t (ny);
+          break;
+        }
+      m_cell *= 2.0;
+    }
+  m_minX = minX;
+  m_minY = minY;
+
+  // counting sort of (cell, jammer) pairs into CSR form
+  m_cellStart.assign (m_nx * m_ny + 1, 0);
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      for (uint32_t i = 0; i < m_entries.size (); i++)
+        {
+          const Entry &entry = m_entries[i];
+          double reach = std::sqrt (entry.reach2);
+          uint32_t x0 = uint32_t ((entry.x - reach - m_minX) / m_cell);
+          uint32_t x1 = std::min (m_nx - 1,
+                                  uint32_t ((entry.x + reach - m_minX) / m_cell));
+          uint32_t y0 = uint32_t ((entry.y - reach - m_minY) / m_cell);
+          uint32_t y1 = std::min (m_ny - 1,
+                                  uint32_t ((entry.y + reach - m_minY) / m_cell));
+          for (uint32_t y = y0; y <= y1; y++)
+            {
+              for (uint32_t x = x0; x <= x1; x++)
+                {
+                  uint32_t cell = y * m_nx + x;
+                  if (pass == 0)
+                    {
+                      m_cellStart[cell + 1]++;
+                    }
+                  else
+                    {
+                      m_cellEntries[m_cellStart[cell]++] = i;
+                    }
+                }
+            }
+        }
+      if (pass == 0)
+        {
+          for (uint32_t cell = 0; cell < m_nx * m_ny; cell++)
+            {
+              m_cellStart[cell + 1] += m_cellStart[cell];
+            }
+          m_cellEntries.resize (m_cellStart[m_nx * m_ny]);
+        }
+    }
+  // the fill pass moved every start to the next cell's start, shift back
+  for (uint32_t cell = m_nx * m_ny; cell > 0; cell--)
+    {
+      m_cellStart[cell] = m_cellStart[cell - 1];
+    }
+  m_cellStart[0] = 0;
+}
+
+void
+JammerSpatialIndex::Query (const Vector &position,
+                           std::vector<uint32_t> &ids) const
+{
+  ids.clear ();
+  if (m_nx == 0)
+    {
+      return;
+    }
+  double fx = (position.x - m_minX) / m_cell;
+  double fy = (position.y - m_minY) / m_cell;
+  if (!(fx >= 0.0 && fy >= 0.0 && fx < m_nx && fy < m_ny))
+    {
+      return; // outside every reach disk
+    }
+  uint32_t cell = uint32_t (fy) * m_nx + uint32_t (fx);
+  for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++)
+    {
+      const Entry &entry = m_entries[m_cellEntries[k]];
+      double dx = position.x - entry.x;
+      double dy = position.y - entry.y;
+      double dz = position.z - entry.z;
+      if (dx * dx + dy * dy + dz * dz <= entry.reach2)
+        {
+          ids.push_back (entry.id);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,125 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_SPATIAL_INDEX_H
+#define JAMMER_SPATIAL_INDEX_H
+
+#include "ns3/vector.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Uniform grid over jammer positions and reach, for scenarios with
+ * many jammers.
+ *
+ * A receiver asks which jammers can reach it above the noise floor, and
+ * only evaluates those. Each jammer is filed in every grid cell its reach
+ * disk overlaps, so a query reads the one cell holding the receiver and
+ * checks the exact distance of the jammers in it. Query cost grows with the
+ * local jammer density, not with the number of jammers.
+ *
+ * The grid is in the x-y plane, distances are 3D. Add the jammers, then
+ * Build; rebuild after jammers move.
+ */
+class JammerSpatialIndex
+{
+public:
+  /**
+   * Reference loss at 1 m and path loss exponent of ns-3's default
+   * LogDistancePropagationLossModel.
+   */
+  static const double DEFAULT_REFERENCE_LOSS;   // 46.6777 dB
+  static const double DEFAULT_PATH_LOSS_EXPONENT; // 3
+  static const double DEFAULT_NOISE_FLOOR;      // -101 dBm, 20 MHz at 290 K
+
+  /**
+   * \param cellSize Grid cell edge in meters, 0 to use the largest reach.
+   */
+  JammerSpatialIndex (double cellSize = 0.0);
+  ~JammerSpatialIndex ();
+
+  /**
+   * \brief Distance at which a jamming signal falls to the noise floor
+   * under log-distance path loss.
+   *
+   * \param txPower Jammer TX power, in Watts.
+   * \param noiseFloor Noise floor, in dBm.
+   * \param exponent Path loss exponent.
+   * \param referenceLoss Path loss at 1 m, in dB.
+   * \returns Reach, in meters.
+   */
+  static double ComputeReach (double txPower,
+                              double noiseFloor = DEFAULT_NOISE_FLOOR,
+                              double exponent = DEFAULT_PATH_LOSS_EXPONENT,
+                              double referenceLoss = DEFAULT_REFERENCE_LOSS);
+
+  /**
+   * \brief Adds a jammer. Takes effect at the next Build.
+   *
+   * \param id Jammer id reported by Query.
+   * \param position Jammer position.
+   * \param reach Jammer reach, in meters.
+   */
+  void Add (uint32_t id, const Vector &position, double reach);
+
+  /**
+   * Removes all jammers.
+   */
+  void Clear (void);
+
+  /**
+   * \returns Number of jammers added.
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \brief Files the added jammers into the grid.
+   */
+  void Build (void);
+
+  /**
+   * \brief Finds the jammers reaching a position.
+   *
+   * \param position Receiver position.
+   * \param ids Cleared, then filled with the ids of the jammers whose reach
+   * covers the position, in the order they were added.
+   */
+  void Query (const Vector &position, std::vector<uint32_t> &ids) const;
+
+private:
+  struct Entry
+  {
+    uint32_t id;
+    double x, y, z;
+    double reach2;      // squared reach
+  };
+
+  double m_cellSize;    // requested cell edge, 0 for automatic
+  std::vector<Entry> m_entries;
+
+  // grid, valid after Build
+  double m_cell;        // cell edge in use
+  double m_minX, m_minY;
+  uint32_t m_nx, m_ny;
+  std::vector<uint32_t> m_cellStart;  // m_nx * m_ny + 1 offsets into m_cellEntries
+  std::vector<uint32_t> m_cellEntries; // m_entries indices, per cell
+};
+
+} // namespace ns3
+
+#endif /* JAMMER_SPATIAL_INDEX_H */
@@ -0,0 +1,89 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jammer-stats.h"
+
+namespace ns3 {
+
+JammerStats::JammerStats ()
+  : node (0),
+    jammerType (NO_JAMMER)
+{
+  Reset ();
+}
+
+void
+JammerStats::Reset (void)
+{
+  eventsScheduled = 0;
+  eventsCancelled = 0;
+  burstsSent = 0;
+  burstsFailed = 0;
+  decisionsJam = 0;
+  decisionsSkip = 0;
+  channelHops = 0;
+  energy = 0.0;
+}
+
+void
+JammerStats::Cancel (EventId &event)
+{
+  if (event.IsRunning ())
+    {
+      event.Cancel ();
+      eventsCancelled++;
+    }
+}
+
+void
+JammerStats::WriteCsv (std::ostream &os, const std::vector<JammerStats> &stats)
+{
+  os << "node,jammer,eventsScheduled,eventsCancelled,burstsSent,burstsFailed,"
+     << "decisionsJam,decisionsSkip,channelHops,energy\n";
+  for (uint32_t i = 0; i < stats.size (); i++)
+    {
+      const JammerStats &s = stats[i];
+      os << s.node << "," << JammerTypeToString (s.jammerType) << ","
+         << s.eventsScheduled << "," << s.eventsCancelled << ","
+         << s.burstsSent << "," << s.burstsFailed << ","
+         << s.decisionsJam << "," << s.decisionsSkip << ","
+         << s.channelHops << "," << s.energy << "\n";
+    }
+}
+
+void
+JammerStats::WriteJson (std::ostream &os, const std::vector<JammerStats> &stats)
+{
+  os << "[";
+  for (uint32_t i = 0; i < stats.size (); i++)
+    {
+      const JammerStats &s = stats[i];
+      os << (i == 0 ? "\n" : ",\n")
+         << "  {\"node\": " << s.node
+         << ", \"jammer\": \"" << JammerTypeToString (s.jammerType) << "\""
+         << ", \"eventsScheduled\": " << s.eventsScheduled
+         << ", \"eventsCancelled\": " << s.eventsCancelled
+         << ", \"burstsSent\": " << s.burstsSent
+         << ", \"burstsFailed\": " << s.burstsFailed
+         << ", \"decisionsJam\": " << s.decisionsJam
+         << ", \"decisionsSkip\": " << s.decisionsSkip
+         << ", \"channelHops\": " << s.channelHops
+         << ", \"energy\": " << s.energy << "}";
+    }
+  os << "\n]\n";
+}
+
+} // namespace ns3
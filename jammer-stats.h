@@ -0,0 +1,76 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_STATS_H
+#define JAMMER_STATS_H
+
+#include "jammer-type.h"
+#include "ns3/event-id.h"
+#include <ostream>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Work counters of one jammer.
+ *
+ * Each jammer keeps one of these and returns a copy from GetStats. Collect
+ * them at the end of the simulation and write them with WriteCsv or
+ * WriteJson.
+ */
+struct JammerStats
+{
+  JammerStats ();
+
+  /**
+   * Zeroes all counters. Node and jammer type are kept.
+   */
+  void Reset (void);
+
+  /**
+   * \brief Cancels an event, counting it only if it was still pending.
+   *
+   * \param event Event to cancel.
+   */
+  void Cancel (EventId &event);
+
+  /**
+   * \brief Writes one CSV line per jammer, preceded by a header line.
+   */
+  static void WriteCsv (std::ostream &os, const std::vector<JammerStats> &stats);
+
+  /**
+   * \brief Writes a JSON array with one object per jammer.
+   */
+  static void WriteJson (std::ostream &os,
+                         const std::vector<JammerStats> &stats);
+
+  uint32_t node;                // jammer id
+  JammerType jammerType;
+  uint64_t eventsScheduled;     // simulator events scheduled by the jammer
+  uint64_t eventsCancelled;     // pending events cancelled by the jammer
+  uint64_t burstsSent;          // successful SendJammingSignal calls
+  uint64_t burstsFailed;        // failed SendJammingSignal calls
+  uint64_t decisionsJam;        // reactive decisions to jam a packet
+  uint64_t decisionsSkip;       // reactive decisions to let a packet pass
+  uint64_t channelHops;         // channel hops reacting to mitigation
+  double energy;                // energy of sent jamming signals, in Joules
+};
+
+} // namespace ns3
+
+#endif /* JAMMER_STATS_H */
@@ -0,0 +1,330 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jammer-timer-wheel.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/*
+ * JammerTimer
+ */
+
+JammerTimer::JammerTimer ()
+  : m_inWheel (false),
+    m_expiry (0),
+    m_slot (0),
+    m_prev (0),
+    m_next (0)
+{
+}
+
+JammerTimer::~JammerTimer ()
+{
+  Cancel ();
+}
+
+void
+JammerTimer::SetFunction (Callback<void> function)
+{
+  m_function = function;
+}
+
+void
+JammerTimer::Schedule (Time delay)
+{
+  Cancel ();
+  if (JammerTimerWheel::m_resolution == 0)
+    {
+      m_event = Simulator::Schedule (delay, &JammerTimer::Expire, this);
+    }
+  else
+    {
+      JammerTimerWheel::Insert (this, delay);
+    }
+}
+
+void
+JammerTimer::Cancel (void)
+{
+  m_event.Cancel ();
+  if (m_inWheel)
+    {
+      JammerTimerWheel::Remove (this);
+    }
+}
+
+bool
+JammerTimer::IsRunning (void) const
+{
+  return m_inWheel || m_event.IsRunning ();
+}
+
+void
+JammerTimer::Expire (void)
+{
+  m_function ();
+}
+
+/*
+ * JammerTimerWheel
+ */
+
+const uint32_t JammerTimerWheel::SLOT_BITS;
+const uint32_t JammerTimerWheel::SLOTS;
+
+int64_t JammerTimerWheel::m_resolution = 0;
+uint64_t JammerTimerWheel::m_current = 0;
+uint32_t JammerTimerWheel::m_count = 0;
+JammerTimer *JammerTimerWheel::m_level0[SLOTS];
+JammerTimer *JammerTimerWheel::m_level1[SLOTS];
+uint64_t JammerTimerWheel::m_occupied[SLOTS / 64];
+JammerTimer *JammerTimerWheel::m_overflow = 0;
+EventId JammerTimerWheel::m_tickEvent;
+uint64_t JammerTimerWheel::m_tickEventTick = 0;
+uint64_t JammerTimerWheel::m_tickEvents = 0;
+bool JammerTimerWheel::m_inTick = false;
+
+void
+JammerTimerWheel::SetResolution (Time resolution)
+{
+  NS_ASSERT (m_count == 0);
+  NS_ASSERT (!resolution.IsStrictlyNegative ());
+  m_resolution = resolution.GetTimeStep ();
+}
+
+Time
+JammerTimerWheel::GetResolution (void)
+{
+  return TimeStep (m_resolution);
+}
+
+Time
+JammerTimerWheel::GetExpiryTime (Time time)
+{
+  if (m_resolution == 0)
+    {
+      return time;
+    }
+  // rounded up as in Insert
+  int64_t ticks = (time.GetTimeStep () + m_resolution - 1) / m_resolution;
+  return TimeStep (ticks * m_resolution);
+}
+
+uint32_t
+JammerTimerWheel::GetPendingCount (void)
+{
+  return m_count;
+}
+
+uint64_t
+JammerTimerWheel::GetTickEventCount (void)
+{
+  return m_tickEvents;
+}
+
+void
+JammerTimerWheel::Insert (JammerTimer *timer, Time delay)
+{
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  if (m_count == 0)
+    {
+      m_current = now / m_resolution; // empty wheel, restart at now
+    }
+  // round up, a timer never expires early
+  uint64_t expiry = (now + delay.GetTimeStep () + m_resolution - 1) / m_resolution;
+  timer->m_expiry = expiry > m_current ? expiry : m_current + 1;
+  Place (timer);
+  m_count++;
+  if (!m_inTick && (!m_tickEvent.IsRunning () ||
+                    timer->m_expiry < m_tickEventTick))
+    {
+      ScheduleTick ();
+    }
+}
+
+void
+JammerTimerWheel::Remove (JammerTimer *timer)
+{
+  Unlink (timer);
+  m_count--;
+  if (m_count == 0)
+    {
+      m_tickEvent.Cancel ();
+    }
+}
+
+void
+JammerTimerWheel::Place (JammerTimer *timer)
+{
+  uint64_t expiry = timer->m_expiry;
+  if ((expiry >> SLOT_BITS) == (m_current >> SLOT_BITS))
+    {
+      Link (timer, &m_level0[expiry & (SLOTS - 1)]);
+    }
+  else if ((expiry >> (2 * SLOT_BITS)) == (m_current >> (2 * SLOT_BITS)))
+    {
+      Link (timer, &m_level1[(expiry >> SLOT_BITS) & (SLOTS - 1)]);
+    }
+  else
+    {
+      Link (timer, &m_overflow);
+    }
+}
+
+void
+JammerTimerWheel::Link (JammerTimer *timer, JammerTimer **slot)
+{
+  timer->m_slot = slot;
+  timer->m_prev = 0;
+  timer->m_next = *slot;
+  if (*slot != 0)
+    {
+      (*slot)->m_prev = timer;
+    }
+  *slot = timer;
+  timer->m_inWheel = true;
+  if (slot >= m_level0 && slot < m_level0 + SLOTS)
+    {
+      uint32_t index = slot - m_level0;
+      m_occupied[index / 64] |= uint64_t (1) << (index % 64);
+    }
+}
+
+void
+JammerTimerWheel::Unlink (JammerTimer *timer)
+{
+  JammerTimer **slot = timer->m_slot;
+  if (timer->m_prev != 0)
+    {
+      timer->m_prev->m_next = timer->m_next;
+    }
+  else
+    {
+      *slot = timer->m_next;
+    }
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer->m_prev;
+    }
+  timer->m_inWheel = false;
+  if (*slot == 0 && slot >= m_level0 && slot < m_level0 + SLOTS)
+    {
+      uint32_t index = slot - m_level0;
+      m_occupied[index / 64] &= ~(uint64_t (1) << (index % 64));
+    }
+}
+
+void
+JammerTimerWheel::Cascade (void)
+{
+  if ((m_current & (SLOTS * SLOTS - 1)) == 0)
+    {
+      // new level 1 rotation: pull in the overflow timers that now fit
+      JammerTimer *timer = m_overflow;
+      while (timer != 0)
+        {
+          JammerTimer *next = timer->m_next;
+          if ((timer->m_expiry >> (2 * SLOT_BITS)) ==
+              (m_current >> (2 * SLOT_BITS)))
+            {
+              Unlink (timer);
+              Place (timer);
+            }
+          timer = next;
+        }
+    }
+  JammerTimer **slot = &m_level1[(m_current >> SLOT_BITS) & (SLOTS - 1)];
+  while (*slot != 0)
+    {
+      JammerTimer *timer = *slot;
+      Unlink (timer);
+      Place (timer);
+    }
+}
+
+void
+JammerTimerWheel::ScheduleTick (void)
+{
+  m_tickEvent.Cancel ();
+  if (m_count == 0)
+    {
+      return;
+    }
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  uint64_t next;
+  for (;;)
+    {
+      // next occupied level 0 slot of this rotation, else the next rotation
+      next = ((m_current >> SLOT_BITS) + 1) << SLOT_BITS;
+      bool occupied = false;
+      uint32_t from = (m_current & (SLOTS - 1)) + 1;
+      for (uint32_t word = from / 64; word < SLOTS / 64; word++)
+        {
+          uint64_t bits = m_occupied[word];
+          if (word == from / 64)
+            {
+              bits &= ~uint64_t (0) << (from % 64);
+            }
+          if (bits != 0)
+            {
+              next = (m_current & ~uint64_t (SLOTS - 1)) + word * 64 +
+                __builtin_ctzll (bits);
+              occupied = true;
+              break;
+            }
+        }
+      if (occupied || int64_t (next) * m_resolution >= now)
+        {
+          break;
+        }
+      // rotation boundary already passed while idle, cascade right away
+      m_current = next;
+      Cascade ();
+    }
+  m_tickEventTick = next;
+  m_tickEvent = Simulator::Schedule (TimeStep (next * m_resolution - now),
+                                     &JammerTimerWheel::Tick);
+  m_tickEvents++;
+}
+
+void
+JammerTimerWheel::Tick (void)
+{
+  while (m_current < m_tickEventTick)
+    {
+      m_current++;
+      if ((m_current & (SLOTS - 1)) == 0)
+        {
+          Cascade ();
+        }
+    }
+
+  m_inTick = true;
+  JammerTimer **slot = &m_level0[m_current & (SLOTS - 1)];
+  while (*slot != 0)
+    {
+      JammerTimer *timer = *slot;
+      Unlink (timer);
+      m_count--;
+      timer->Expire (); // may schedule timers, always for later ticks
+    }
+  m_inTick = false;
+  ScheduleTick ();
+}
+
+} // namespace ns3
@@ -0,0 +1,153 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_TIMER_WHEEL_H
+#define JAMMER_TIMER_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief One-shot jammer timer.
+ *
+ * While the JammerTimerWheel is disabled (the default) the timer is a plain
+ * simulator event. Once a wheel resolution is set, the timer is kept in the
+ * shared wheel instead, and expires at the first wheel tick at or after its
+ * expiry time.
+ */
+class JammerTimer
+{
+public:
+  JammerTimer ();
+  ~JammerTimer ();
+
+  /**
+   * \param function Function called when the timer expires.
+   */
+  void SetFunction (Callback<void> function);
+
+  /**
+   * \brief Starts the timer, cancelling it first if it is running.
+   *
+   * \param delay Time until expiry.
+   */
+  void Schedule (Time delay);
+
+  /**
+   * Stops the timer if it is running.
+   */
+  void Cancel (void);
+
+  /**
+   * \returns True if the timer is scheduled and has not expired.
+   */
+  bool IsRunning (void) const;
+
+private:
+  friend class JammerTimerWheel;
+
+  // not copyable, the wheel links to the timer
+  JammerTimer (JammerTimer const &);
+  JammerTimer &operator= (JammerTimer const &);
+
+  void Expire (void);
+
+  Callback<void> m_function;
+  EventId m_event;        // expiry event, when the wheel is disabled
+  bool m_inWheel;         // true while linked into the wheel
+  uint64_t m_expiry;      // expiry, in wheel ticks
+  JammerTimer **m_slot;   // head of the wheel slot list holding the timer
+  JammerTimer *m_prev;    // wheel slot list links
+  JammerTimer *m_next;
+};
+
+/**
+ * \brief Timing wheel shared by all jammer timers of a simulation.
+ *
+ * All timers expiring in the same tick are served by one simulator event,
+ * and insert and cancel are O(1). Two levels of 256 slots cover 65536 ticks;
+ * later timers wait in an overflow list that is sorted into the wheel every
+ * 65536 ticks. Only one simulator event is pending at a time, for the next
+ * occupied tick (or the next level boundary).
+ *
+ * Timers expire up to one resolution late, so use it for timers whose
+ * exact expiry does not matter, like RX timeouts.
+ */
+class JammerTimerWheel
+{
+public:
+  /**
+   * \brief Sets the tick length and enables the wheel.
+   *
+   * \param resolution Tick length, 0 to disable the wheel.
+   *
+   * Only takes effect for timers scheduled afterwards; set it before the
+   * simulation starts.
+   */
+  static void SetResolution (Time resolution);
+  static Time GetResolution (void);
+
+  /**
+   * \returns Time at which a timer due at time expires: time itself while
+   * the wheel is disabled, else the first tick at or after it.
+   */
+  static Time GetExpiryTime (Time time);
+
+  /**
+   * \returns Number of timers in the wheel.
+   */
+  static uint32_t GetPendingCount (void);
+
+  /**
+   * \returns Number of simulator events the wheel has scheduled.
+   */
+  static uint64_t GetTickEventCount (void);
+
+private:
+  friend class JammerTimer;
+
+  static const uint32_t SLOT_BITS = 8;
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+
+  static void Insert (JammerTimer *timer, Time delay);
+  static void Remove (JammerTimer *timer);
+  static void Place (JammerTimer *timer);
+  static void Link (JammerTimer *timer, JammerTimer **slot);
+  static void Unlink (JammerTimer *timer);
+  static void Tick (void);
+  static void Cascade (void);
+  static void ScheduleTick (void);
+
+  static int64_t m_resolution;              // tick length, in time steps
+  static uint64_t m_current;                // last processed tick
+  static uint32_t m_count;                  // timers in the wheel
+  static JammerTimer *m_level0[SLOTS];      // one slot per tick
+  static JammerTimer *m_level1[SLOTS];      // one slot per SLOTS ticks
+  static uint64_t m_occupied[SLOTS / 64];   // non-empty level 0 slots
+  static JammerTimer *m_overflow;           // timers beyond level 1
+  static EventId m_tickEvent;
+  static uint64_t m_tickEventTick;          // tick m_tickEvent is for
+  static uint64_t m_tickEvents;
+  static bool m_inTick;                     // true while expiring timers
+};
+
+} // namespace ns3
+
+#endif /* JAMMER_TIMER_WHEEL_H */
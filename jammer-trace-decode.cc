@@ -0,0 +1,111 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Prints a jammer trace written by JammerTraceBuffer::Dump as text, one
+ * event per line.
+ *
+ * Usage:
+ *   jammer-trace-decode FILE [--node=N] [--event=NAME]
+ */
+
+#include "jammer-trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  if (argc < 2)
+    {
+      std::cerr << "Usage: " << argv[0] << " FILE [--node=N] [--event=NAME]"
+                << std::endl;
+      return 1;
+    }
+  long node = -1;
+  const char *eventName = NULL;
+  for (int i = 2; i < argc; i++)
+    {
+      if (std::strncmp (argv[i], "--node=", 7) == 0)
+        {
+          node = std::strtol (argv[i] + 7, NULL, 10);
+        }
+      else if (std::strncmp (argv[i], "--event=", 8) == 0)
+        {
+          eventName = argv[i] + 8;
+        }
+      else
+        {
+          std::cerr << "Unknown option " << argv[i] << std::endl;
+          return 1;
+        }
+    }
+
+  std::vector<JammerTraceEvent> events;
+  uint64_t recorded;
+  if (!JammerTraceBuffer::Load (argv[1], events, recorded))
+    {
+      std::cerr << "Cannot read jammer trace " << argv[1] << std::endl;
+      return 1;
+    }
+  if (recorded > events.size ())
+    {
+      std::printf ("# %llu oldest events were overwritten\n",
+                   (unsigned long long) (recorded - events.size ()));
+    }
+
+  for (uint32_t i = 0; i < events.size (); i++)
+    {
+      const JammerTraceEvent &e = events[i];
+      const char *name = JammerTraceEventToString (e.event);
+      if ((node >= 0 && e.node != uint32_t (node)) ||
+          (eventName != NULL && std::strcmp (eventName, name) != 0))
+        {
+          continue;
+        }
+      std::printf ("%.9f %s Node #%u %s", e.time / 1e9,
+                   JammerTypeToString (JammerType (e.jammerType)), e.node, name);
+      switch (e.event)
+        {
+        case JAMMER_TRACE_BURST_SENT:
+        case JAMMER_TRACE_BURST_FAILED:
+        case JAMMER_TRACE_BURST_END:
+          std::printf (" power=%g W", e.value);
+          break;
+        case JAMMER_TRACE_RX_START:
+        case JAMMER_TRACE_RX_END:
+          std::printf (" rss=%g W", e.value);
+          break;
+        case JAMMER_TRACE_JAM_DECISION:
+          std::printf (" jam=%u probability=%g", e.arg, e.value);
+          break;
+        case JAMMER_TRACE_RX_TIMEOUT:
+          std::printf (" react=%u", e.arg);
+          break;
+        case JAMMER_TRACE_CHANNEL_HOP:
+          std::printf (" %u->%u", e.arg >> 16, e.arg & 0xffff);
+          break;
+        default:
+          break;
+        }
+      std::printf ("\n");
+    }
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jammer-trace.h"
+#include <fstream>
+
+namespace ns3 {
+
+const uint32_t JammerTraceBuffer::MAGIC;
+const uint32_t JammerTraceBuffer::DEFAULT_CAPACITY;
+
+std::vector<JammerTraceEvent> JammerTraceBuffer::m_events;
+uint64_t JammerTraceBuffer::m_mask = 0;
+uint64_t JammerTraceBuffer::m_next = 0;
+
+const char *
+JammerTraceEventToString (uint8_t event)
+{
+  switch (event)
+    {
+    case JAMMER_TRACE_JAMMER_OFF:
+      return "jammer-off";
+    case JAMMER_TRACE_BURST_SENT:
+      return "burst-sent";
+    case JAMMER_TRACE_BURST_FAILED:
+      return "burst-failed";
+    case JAMMER_TRACE_BURST_END:
+      return "burst-end";
+    case JAMMER_TRACE_RX_START:
+      return "rx-start";
+    case JAMMER_TRACE_RX_END:
+      return "rx-end";
+    case JAMMER_TRACE_JAM_DECISION:
+      return "jam-decision";
+    case JAMMER_TRACE_REACTING:
+      return "reacting";
+    case JAMMER_TRACE_RX_TIMEOUT:
+      return "rx-timeout";
+    case JAMMER_TRACE_CHANNEL_HOP:
+      return "channel-hop";
+    default:
+      break;
+    }
+  return "unknown";
+}
+
+void
+JammerTraceBuffer::SetCapacity (uint32_t events)
+{
+  uint64_t capacity = 1;
+  while (capacity < events)
+    {
+      capacity <<= 1;
+    }
+  m_events.assign (capacity, JammerTraceEvent ());
+  m_mask = capacity - 1;
+  m_next = 0;
+}
+
+uint64_t
+JammerTraceBuffer::GetRecordedCount (void)
+{
+  return m_next;
+}
+
+bool
+JammerTraceBuffer::Dump (std::string const &filename)
+{
+  std::ofstream file (filename.c_str (), std::ios::out | std::ios::binary);
+  if (!file.is_open ())
+    {
+      return false;
+    }
+  uint64_t stored = m_next < m_events.size () ? m_next : m_events.size ();
+  uint32_t header[2] = { MAGIC, sizeof (JammerTraceEvent) };
+  file.write (reinterpret_cast<const char *> (header), sizeof (header));
+  file.write (reinterpret_cast<const char *> (&m_next), sizeof (m_next));
+  file.write (reinterpret_cast<const char *> (&stored), sizeof (stored));
+  // oldest first: the ring may have wrapped
+  for (uint64_t i = m_next - stored; i < m_next; i++)
+    {
+      file.write (reinterpret_cast<const char *> (&m_events[i & m_mask]),
+                  sizeof (JammerTraceEvent));
+    }
+  file.close ();
+  return !file.fail ();
+}
+
+bool
+JammerTraceBuffer::Load (std::string const &filename,
+                         std::vector<JammerTraceEvent> &events,
+                         uint64_t &recorded)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  uint32_t header[2];
+  uint64_t stored;
+  file.read (reinterpret_cast<char *> (header), sizeof (header));
+  file.read (reinterpret_cast<char *> (&recorded), sizeof (recorded));
+  file.read (reinterpret_cast<char *> (&stored), sizeof (stored));
+  if (!file || header[0] != MAGIC ||
+      header[1] != sizeof (JammerTraceEvent) || stored > recorded)
+    {
+      return false;
+    }
+  // a truncated or corrupt file must not size the vector
+  std::streampos start = file.tellg ();
+  file.seekg (0, std::ios::end);
+  uint64_t remaining = file.tellg () - start;
+  file.seekg (start);
+  if (!file || stored > remaining / sizeof (JammerTraceEvent))
+    {
+      return false;
+    }
+  events.resize (stored);
+  if (stored > 0)
+    {
+      file.read (reinterpret_cast<char *> (&events[0]),
+                 stored * sizeof (JammerTraceEvent));
+    }
+  return static_cast<bool> (file);
+}
+
+void
+JammerTraceBuffer::Clear (void)
+{
+  m_next = 0;
+}
+
+} // namespace ns3
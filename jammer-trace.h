@@ -0,0 +1,171 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_TRACE_H
+#define JAMMER_TRACE_H
+
+#include "jammer-type.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * Structured binary tracing for the jammer per-packet and per-burst paths.
+ *
+ * JAMMER_TRACE records a fixed-size event into a per-simulation ring buffer
+ * instead of formatting a log message. It is only compiled in when
+ * NS3_JAMMER_TRACE_ENABLE is defined; otherwise it expands to nothing and
+ * its arguments are not evaluated. Dump the buffer with
+ * JammerTraceBuffer::Dump and decode it offline with jammer-trace-decode.
+ */
+
+namespace ns3 {
+
+/**
+ * Jammer trace event types. Meaning of the arg and value fields in comments.
+ */
+enum JammerTraceEventType {
+  JAMMER_TRACE_JAMMER_OFF = 0,  // burst skipped, jammer is off
+  JAMMER_TRACE_BURST_SENT,      // value: actual TX power (W)
+  JAMMER_TRACE_BURST_FAILED,    // value: requested TX power (W)
+  JAMMER_TRACE_BURST_END,       // value: TX power of the burst (W)
+  JAMMER_TRACE_RX_START,        // value: start RSS (W)
+  JAMMER_TRACE_RX_END,          // value: average RSS (W)
+  JAMMER_TRACE_JAM_DECISION,    // arg: 1 to jam, 0 not; value: probability
+  JAMMER_TRACE_REACTING,        // next burst delayed by channel switch
+  JAMMER_TRACE_RX_TIMEOUT,      // arg: 1 if react to mitigation is on
+  JAMMER_TRACE_CHANNEL_HOP,     // arg: from channel << 16 | to channel
+  JAMMER_TRACE_EVENT_COUNT      // number of event types, not a valid type
+};
+
+/**
+ * \returns Name of a trace event type.
+ */
+const char * JammerTraceEventToString (uint8_t event);
+
+/**
+ * One trace event, 32 bytes.
+ */
+struct JammerTraceEvent
+{
+  int64_t time;         // simulation time, in nanoseconds
+  double value;
+  uint32_t node;        // jammer id
+  uint32_t arg;
+  uint8_t jammerType;   // JammerType
+  uint8_t event;        // JammerTraceEventType
+  uint16_t reserved;
+  uint32_t padding;
+};
+
+/**
+ * \brief Ring buffer holding the most recent jammer trace events of a
+ * simulation.
+ *
+ * When full, the oldest events are overwritten. All members are static:
+ * there is one buffer per simulation process.
+ */
+class JammerTraceBuffer
+{
+public:
+  static const uint32_t MAGIC = 0x5645544a;   // "JTEV"
+  static const uint32_t DEFAULT_CAPACITY = 1 << 20;
+
+  /**
+   * \brief Sets buffer capacity, rounded up to a power of two. Clears the
+   * buffer.
+   */
+  static void SetCapacity (uint32_t events);
+
+  /**
+   * \brief Records one event.
+   */
+  static inline void Record (int64_t time, uint32_t node, uint8_t jammerType,
+                             uint8_t event, uint32_t arg, double value)
+  {
+    if (m_events.empty ())
+      {
+        SetCapacity (DEFAULT_CAPACITY);
+      }
+    JammerTraceEvent &e = m_events[m_next & m_mask];
+    e.time = time;
+    e.value = value;
+    e.node = node;
+    e.arg = arg;
+    e.jammerType = jammerType;
+    e.event = event;
+    e.reserved = 0;
+    e.padding = 0;
+    m_next++;
+  }
+
+  /**
+   * \returns Number of events recorded since the last clear, including
+   * overwritten ones.
+   */
+  static uint64_t GetRecordedCount (void);
+
+  /**
+   * \brief Writes the buffered events, oldest first.
+   *
+   * \param filename Output file.
+   * \returns False if the file cannot be written.
+   *
+   * Layout: uint32 magic, uint32 event size, uint64 recorded count,
+   * uint64 stored count, then the stored events.
+   */
+  static bool Dump (std::string const &filename);
+
+  /**
+   * \brief Reads a file written by Dump.
+   *
+   * \param filename Input file.
+   * \param events Filled with the stored events, oldest first.
+   * \param recorded Set to the number of events recorded in the simulation.
+   * \returns False if the file cannot be read.
+   */
+  static bool Load (std::string const &filename,
+                    std::vector<JammerTraceEvent> &events, uint64_t &recorded);
+
+  /**
+   * Drops all buffered events.
+   */
+  static void Clear (void);
+
+private:
+  static std::vector<JammerTraceEvent> m_events;
+  static uint64_t m_mask;
+  static uint64_t m_next;   // index of next event, never wraps
+};
+
+} // namespace ns3
+
+#ifdef NS3_JAMMER_TRACE_ENABLE
+
+#include "ns3/simulator.h"
+
+#define JAMMER_TRACE(jammerType, event, node, arg, value)               \
+  ns3::JammerTraceBuffer::Record (ns3::Simulator::Now ().GetNanoSeconds (), \
+                                  node, jammerType, ns3::event, arg, value)
+
+#else /* NS3_JAMMER_TRACE_ENABLE */
+
+#define JAMMER_TRACE(jammerType, event, node, arg, value)
+
+#endif /* NS3_JAMMER_TRACE_ENABLE */
+
+#endif /* JAMMER_TRACE_H */
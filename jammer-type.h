@@ -0,0 +1,62 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMER_TYPE_H
+#define JAMMER_TYPE_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * Jammer classes, numbered the same way as the labels used by
+ * classification.ipynb (0 = no jammer, 1 = constant, 2 = reactive,
+ * 3 = random).
+ */
+enum JammerType {
+  NO_JAMMER = 0,
+  CONSTANT_JAMMER,
+  REACTIVE_JAMMER,
+  RANDOM_JAMMER,
+  JAMMER_TYPE_COUNT   // number of jammer classes, not a valid type
+};
+
+/**
+ * \param type Jammer type.
+ * \returns Name used for the type in data file names (eg. "constantjammer").
+ */
+inline const char *
+JammerTypeToString (JammerType type)
+{
+  switch (type)
+    {
+    case NO_JAMMER:
+      return "nojammer";
+    case CONSTANT_JAMMER:
+      return "constantjammer";
+    case REACTIVE_JAMMER:
+      return "reactivejammer";
+    case RANDOM_JAMMER:
+      return "randomjammer";
+    default:
+      break;
+    }
+  return "unknown";
+}
+
+} // namespace ns3
+
+#endif /* JAMMER_TYPE_H */
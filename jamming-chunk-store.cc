@@ -0,0 +1,551 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-chunk-store.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace ns3 {
+
+namespace {
+
+const char MANIFEST_HEADER[] = "# jamming chunk store manifest v1";
+
+/**
+ * Random 64-bit value per byte for the gear rolling hash.
+ */
+class GearTable
+{
+public:
+  GearTable ()
+  {
+    uint64_t state = 0x6a09e667f3bcc908ULL;
+    for (uint32_t i = 0; i < 256; i++)
+      {
+        // splitmix64
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        m_gear[i] = z ^ (z >> 31);
+      }
+  }
+
+  uint64_t operator[] (uint8_t byte) const
+  {
+    return m_gear[byte];
+  }
+
+private:
+  uint64_t m_gear[256];
+};
+
+const GearTable g_gear;
+
+/**
+ * Plain FIPS 180-4 SHA-256.
+ */
+class Sha256
+{
+public:
+  Sha256 ()
+    : m_length (0),
+      m_used (0)
+  {
+    static const uint32_t init[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    std::memcpy (m_state, init, sizeof (m_state));
+  }
+
+  void Update (const uint8_t *data, uint64_t size)
+  {
+    m_length += size;
+    while (size > 0)
+      {
+        uint32_t n = 64 - m_used;
+        if (n > size)
+          {
+            n = size;
+          }
+        std::memcpy (m_block + m_used, data, n);
+        m_used += n;
+        data += n;
+        size -= n;
+        if (m_used == 64)
+          {
+            Compress ();
+            m_used = 0;
+          }
+      }
+  }
+
+  std::string Finish (void)
+  {
+    uint64_t bits = m_length * 8;
+    uint8_t pad = 0x80;
+    Update (&pad, 1);
+    pad = 0;
+    while (m_used != 56)
+      {
+        Update (&pad, 1);
+      }
+    uint8_t length[8];
+    for (uint32_t i = 0; i < 8; i++)
+      {
+        length[i] = bits >> (56 - 8 * i);
+      }
+    Update (length, 8);
+
+    static const char hex[] = "0123456789abcdef";
+    std::string digest (64, '0');
+    for (uint32_t i = 0; i < 32; i++)
+      {
+        uint8_t byte = m_state[i / 4] >> (24 - 8 * (i % 4));
+        digest[2 * i] = hex[byte >> 4];
+        digest[2 * i + 1] = hex[byte & 15];
+      }
+    return digest;
+  }
+
+private:
+  static uint32_t Rotr (uint32_t x, uint32_t n)
+  {
+    return (x >> n) | (x << (32 - n));
+  }
+
+  void Compress (void)
+  {
+    static const uint32_t k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    uint32_t w[64];
+    for (uint32_t i = 0; i < 16; i++)
+      {
+        w[i] = uint32_t (m_block[4 * i]) << 24 | uint32_t (m_block[4 * i + 1]) << 16
+          | uint32_t (m_block[4 * i + 2]) << 8 | m_block[4 * i + 3];
+      }
+    for (uint32_t i = 16; i < 64; i++)
+      {
+        uint32_t s0 = Rotr (w[i - 15], 7) ^ Rotr (w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = Rotr (w[i - 2], 17) ^ Rotr (w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+      }
+    uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+    uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+    for (uint32_t i = 0; i < 64; i++)
+      {
+        uint32_t s1 = Rotr (e, 6) ^ Rotr (e, 11) ^ Rotr (e, 25);
+        uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + k[i] + w[i];
+        uint32_t s0 = Rotr (a, 2) ^ Rotr (a, 13) ^ Rotr (a, 22);
+        uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+      }
+    m_state[0] += a;
+    m_state[1] += b;
+    m_state[2] += c;
+    m_state[3] += d;
+    m_state[4] += e;
+    m_state[5] += f;
+    m_state[6] += g;
+    m_state[7] += h;
+  }
+
+  uint32_t m_state[8];
+  uint8_t m_block[64];
+  uint64_t m_length;
+  uint32_t m_used;
+};
+
+bool
+MakeDirectory (std::string const &path)
+{
+  return mkdir (path.c_str (), 0777) == 0 || errno == EEXIST;
+}
+
+bool
+FileExists (std::string const &path)
+{
+  struct stat st;
+  return stat (path.c_str (), &st) == 0;
+}
+
+bool
+ReadWholeFile (std::string const &filename, std::string &data)
+{
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  if (!in)
+    {
+      return false;
+    }
+  std::ostringstream os;
+  os << in.rdbuf ();
+  data = os.str ();
+  return !in.bad ();
+}
+
+/**
+ * Writes a file through a temporary and a rename, so readers never see a
+ * partial file.
+ */
+bool
+WriteWholeFile (std::string const &filename, const char *data, uint64_t size)
+{
+  std::string temp = filename + ".tmp";
+  std::FILE *file = std::fopen (temp.c_str (), "wb");
+  if (file == NULL)
+    {
+      return false;
+    }
+  bool ok = std::fwrite (data, 1, size, file) == size;
+  ok = std::fclose (file) == 0 && ok;
+  if (!ok || std::rename (temp.c_str (), filename.c_str ()) != 0)
+    {
+      std::remove (temp.c_str ());
+      return false;
+    }
+  return true;
+}
+
+bool
+IsName (std::string const &name)
+{
+  return !name.empty () && name.find_first_of (" \t\r\n") == std::string::npos;
+}
+
+} // anonymous namespace
+
+/*
+ * JammingChunkKey
+ */
+
+JammingChunkKey::JammingChunkKey ()
+  : node (0)
+{
+}
+
+JammingChunkKey::JammingChunkKey (std::string const &sweep,
+                                  std::string const &jammer,
+                                  uint32_t node, std::string const &stream)
+  : sweep (sweep),
+    jammer (jammer),
+    node (node),
+    stream (stream)
+{
+}
+
+bool
+JammingChunkKey::operator< (const JammingChunkKey &other) const
+{
+  if (sweep != other.sweep)
+    {
+      return sweep < other.sweep;
+    }
+  if (jammer != other.jammer)
+    {
+      return jammer < other.jammer;
+    }
+  if (node != other.node)
+    {
+      return node < other.node;
+    }
+  return stream < other.stream;
+}
+
+/*
+ * JammingChunkStore
+ */
+
+const uint32_t JammingChunkStore::MIN_CHUNK;
+const uint32_t JammingChunkStore::MAX_CHUNK;
+const uint32_t JammingChunkStore::CUT_BITS;
+
+JammingChunkStore::JammingChunkStore ()
+  : m_newChunks (0),
+    m_duplicateChunks (0)
+{
+}
+
+JammingChunkStore::~JammingChunkStore ()
+{
+}
+
+bool
+JammingChunkStore::Open (std::string const &root)
+{
+  m_root = root;
+  m_files.clear ();
+  if (!MakeDirectory (m_root) || !MakeDirectory (m_root + "/chunks"))
+    {
+      return false;
+    }
+
+  std::ifstream in ((m_root + "/manifest").c_str ());
+  if (!in)
+    {
+      return true; // new store
+    }
+  std::string line;
+  if (!std::getline (in, line) || line != MANIFEST_HEADER)
+    {
+      return false;
+    }
+  // sweep jammer node stream size count hash...
+  while (std::getline (in, line))
+    {
+      if (line.empty ())
+        {
+          continue;
+        }
+      std::istringstream is (line);
+      JammingChunkKey key;
+      File file;
+      uint32_t count;
+      if (!(is >> key.sweep >> key.jammer >> key.node >> key.stream
+            >> file.size >> count))
+        {
+          return false;
+        }
+      file.chunks.resize (count);
+      for (uint32_t i = 0; i < count; i++)
+        {
+          if (!(is >> file.chunks[i]) || file.chunks[i].size () != 64)
+            {
+              return false;
+            }
+        }
+      m_files[key] = file;
+    }
+  return true;
+}
+
+bool
+JammingChunkStore::Put (const JammingChunkKey &key, const char *data,
+                        uint64_t size)
+{
+  if (!IsName (key.sweep) || !IsName (key.jammer) || !IsName (key.stream))
+    {
+      return false;
+    }
+  std::vector<uint64_t> ends;
+  Split (data, size, ends);
+  File file;
+  file.size = size;
+  uint64_t begin = 0;
+  for (uint32_t i = 0; i < ends.size (); i++)
+    {
+      std::string hash = Hash (data + begin, ends[i] - begin);
+      if (!WriteChunk (hash, data + begin, ends[i] - begin))
+        {
+          return false;
+        }
+      file.chunks.push_back (hash);
+      begin = ends[i];
+    }
+  m_files[key] = file;
+  return true;
+}
+
+bool
+JammingChunkStore::PutFile (const JammingChunkKey &key,
+                            std::string const &filename)
+{
+  std::string data;
+  return ReadWholeFile (filename, data) &&
+         Put (key, data.data (), data.size ());
+}
+
+bool
+JammingChunkStore::Get (const JammingChunkKey &key, std::string &data) const
+{
+  std::map<JammingChunkKey, File>::const_iterator it = m_files.find (key);
+  if (it == m_files.end ())
+    {
+      return false;
+    }
+  data.clear ();
+  data.reserve (it->second.size);
+  std::string chunk;
+  for (uint32_t i = 0; i < it->second.chunks.size (); i++)
+    {
+      const std::string &hash = it->second.chunks[i];
+      if (!ReadWholeFile (ChunkPath (hash), chunk) ||
+          Hash (chunk.data (), chunk.size ()) != hash)
+        {
+          return false;
+        }
+      data += chunk;
+    }
+  return data.size () == it->second.size;
+}
+
+bool
+JammingChunkStore::GetFile (const JammingChunkKey &key,
+                            std::string const &filename) const
+{
+  std::string data;
+  return Get (key, data) && WriteWholeFile (filename, data.data (), data.size ());
+}
+
+const std::vector<std::string> *
+JammingChunkStore::GetChunks (const JammingChunkKey &key) const
+{
+  std::map<JammingChunkKey, File>::const_iterator it = m_files.find (key);
+  return it == m_files.end () ? NULL : &it->second.chunks;
+}
+
+std::vector<JammingChunkKey>
+JammingChunkStore::GetKeys (void) const
+{
+  std::vector<JammingChunkKey> keys;
+  for (std::map<JammingChunkKey, File>::const_iterator it = m_files.begin ();
+       it != m_files.end (); ++it)
+    {
+      keys.push_back (it->first);
+    }
+  return keys;
+}
+
+bool
+JammingChunkStore::Flush (void)
+{
+  std::ostringstream os;
+  os << MANIFEST_HEADER << "\n";
+  for (std::map<JammingChunkKey, File>::const_iterator it = m_files.begin ();
+       it != m_files.end (); ++it)
+    {
+      const JammingChunkKey &key = it->first;
+      os << key.sweep << " " << key.jammer << " " << key.node << " "
+         << key.stream << " " << it->second.size << " "
+         << it->second.chunks.size ();
+      for (uint32_t i = 0; i < it->second.chunks.size (); i++)
+        {
+          os << " " << it->second.chunks[i];
+        }
+      os << "\n";
+    }
+  std::string manifest = os.str ();
+  return WriteWholeFile (m_root + "/manifest", manifest.data (),
+                         manifest.size ());
+}
+
+uint64_t
+JammingChunkStore::GetNewChunkCount (void) const
+{
+  return m_newChunks;
+}
+
+uint64_t
+JammingChunkStore::GetDuplicateChunkCount (void) const
+{
+  return m_duplicateChunks;
+}
+
+void
+JammingChunkStore::Split (const char *data, uint64_t size,
+                          std::vector<uint64_t> &ends)
+{
+  const uint64_t mask = (uint64_t (1) << CUT_BITS) - 1;
+  ends.clear ();
+  uint64_t begin = 0;
+  uint64_t lastNewline = 0;   // end of the last line in the current chunk
+  uint64_t hash = 0;
+  for (uint64_t i = 0; i < size; i++)
+    {
+      // the gear hash only depends on the last 64 bytes
+      hash = (hash << 1) + g_gear[uint8_t (data[i])];
+      if (data[i] == '\n')
+        {
+          lastNewline = i + 1;
+          // the top bits mix the most bytes
+          if (i + 1 - begin >= MIN_CHUNK && ((hash >> (64 - CUT_BITS)) & mask) == 0)
+            {
+              ends.push_back (i + 1);
+              begin = i + 1;
+              continue;
+            }
+        }
+      if (i + 1 - begin == MAX_CHUNK)
+        {
+          // too long: cut after the last whole line, or here if there is none
+          uint64_t end = lastNewline > begin ? lastNewline : i + 1;
+          ends.push_back (end);
+          begin = end;
+        }
+    }
+  if (begin < size)
+    {
+      ends.push_back (size);
+    }
+}
+
+std::string
+JammingChunkStore::Hash (const char *data, uint64_t size)
+{
+  Sha256 sha;
+  sha.Update (reinterpret_cast<const uint8_t *> (data), size);
+  return sha.Finish ();
+}
+
+std::string
+JammingChunkStore::ChunkPath (std::string const &hash) const
+{
+  return m_root + "/chunks/" + hash.substr (0, 2) + "/" + hash;
+}
+
+bool
+JammingChunkStore::WriteChunk (std::string const &hash, const char *data,
+                               uint64_t size)
+{
+  std::string path = ChunkPath (hash);
+  if (FileExists (path))
+    {
+      m_duplicateChunks++;
+      return true;
+    }
+  if (!MakeDirectory (m_root + "/chunks/" + hash.substr (0, 2)) ||
+      !WriteWholeFile (path, data, size))
+    {
+      return false;
+    }
+  m_newChunks++;
+  return true;
+}
+
+} // namespace ns3
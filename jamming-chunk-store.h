@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_CHUNK_STORE_H
+#define JAMMING_CHUNK_STORE_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Names one logical dataset file, eg. data/power/rss_constantjammer_node2.txt
+ * is ("power", "constantjammer", 2, "rss").
+ */
+struct JammingChunkKey
+{
+  JammingChunkKey ();
+  JammingChunkKey (std::string const &sweep, std::string const &jammer,
+                   uint32_t node, std::string const &stream);
+
+  bool operator< (const JammingChunkKey &other) const;
+
+  std::string sweep;    // sweep name, eg. "power"
+  std::string jammer;   // jammer name, eg. "constantjammer"
+  uint32_t node;        // receiving node
+  std::string stream;   // "rss", "pdr", or "trace" for a JammingTraceFile
+};
+
+/**
+ * \brief Content-addressed, deduplicated store for generated datasets.
+ *
+ * Files are cut into content-defined chunks and each unique chunk is stored
+ * once, under its SHA-256, in <root>/chunks/<2 hex digits>/<hash>. The
+ * manifest <root>/manifest maps every JammingChunkKey to its size and chunk
+ * list, so readers get the same logical files back.
+ *
+ * Chunk boundaries only fall after a newline and depend on the preceding
+ * bytes, not on the offset, so traces sharing runs of lines share chunks
+ * even when other lines were inserted or removed in between. Binary data
+ * without newlines is cut at MAX_CHUNK.
+ *
+ * Changes to the manifest are written by Flush.
+ */
+class JammingChunkStore
+{
+public:
+  static const uint32_t MIN_CHUNK = 2048;     // smallest cut chunk
+  static const uint32_t MAX_CHUNK = 65536;    // largest chunk
+  static const uint32_t CUT_BITS = 9;         // 1 in 512 newlines cuts
+
+  JammingChunkStore ();
+  ~JammingChunkStore ();
+
+  /**
+   * \brief Opens a store, creating it if needed, and loads its manifest.
+   *
+   * \param root Store directory.
+   * \returns False if the directory cannot be created or the manifest is
+   * malformed.
+   */
+  bool Open (std::string const &root);
+
+  /**
+   * \brief Stores a file, replacing any file with the same key.
+   *
+   * \returns False if a chunk cannot be written.
+   */
+  bool Put (const JammingChunkKey &key, const char *data, uint64_t size);
+  bool PutFile (const JammingChunkKey &key, std::string const &filename);
+
+  /**
+   * \brief Reads a file back.
+   *
+   * \returns False if the key is unknown or a chunk is missing or damaged.
+   */
+  bool Get (const JammingChunkKey &key, std::string &data) const;
+  bool GetFile (const JammingChunkKey &key, std::string const &filename) const;
+
+  /**
+   * \returns Chunk hashes of a file, or NULL if the key is unknown. Files
+   * with equal chunk lists have equal content.
+   */
+  const std::vector<std::string> * GetChunks (const JammingChunkKey &key) const;
+
+  /**
+   * \returns Keys of all stored files, in order.
+   */
+  std::vector<JammingChunkKey> GetKeys (void) const;
+
+  /**
+   * \brief Writes the manifest.
+   *
+   * \returns False if the manifest cannot be written.
+   */
+  bool Flush (void);
+
+  /**
+   * \returns Chunks written by Put calls, and chunks Put found already
+   * stored.
+   */
+  uint64_t GetNewChunkCount (void) const;
+  uint64_t GetDuplicateChunkCount (void) const;
+
+  /**
+   * \brief Cuts data into chunks.
+   *
+   * \param ends Cleared, then filled with the end offset of every chunk.
+   */
+  static void Split (const char *data, uint64_t size,
+                     std::vector<uint64_t> &ends);
+
+  /**
+   * \returns SHA-256 of data, as 64 lowercase hex digits.
+   */
+  static std::string Hash (const char *data, uint64_t size);
+
+private:
+  struct File
+  {
+    uint64_t size;
+    std::vector<std::string> chunks;
+  };
+
+  std::string ChunkPath (std::string const &hash) const;
+  bool WriteChunk (std::string const &hash, const char *data, uint64_t size);
+
+  std::string m_root;
+  std::map<JammingChunkKey, File> m_files;
+  uint64_t m_newChunks;
+  uint64_t m_duplicateChunks;
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_CHUNK_STORE_H */
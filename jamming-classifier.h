@@ -0,0 +1,71 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_CLASSIFIER_H
+#define JAMMING_CLASSIFIER_H
+
+#include "jamming-dataset.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \brief Base class of classifiers over min-max scaled (RSS, PDR) features.
+ *
+ * Classifiers only depend on header-only parts of ns-3 core, so they can be
+ * used by offline tools as well as by JammingDetector inside a simulation.
+ */
+class JammingClassifier : public SimpleRefCount<JammingClassifier>
+{
+public:
+  virtual ~JammingClassifier ();
+
+  /**
+   * \param feature Scaled feature.
+   * \returns Predicted JammerType.
+   */
+  virtual JammerType Classify (const JammingFeature &feature) const = 0;
+
+  /**
+   * \brief Classifies a batch of features.
+   *
+   * \param features Scaled features.
+   * \param labels Predicted JammerType of each feature.
+   * \param n Number of features.
+   *
+   * Default implementation calls Classify for each feature. Classifiers with
+   * a faster batch path override it.
+   */
+  virtual void ClassifyBatch (const JammingFeature *features, uint8_t *labels,
+                              uint32_t n) const;
+
+  /**
+   * \brief Lists the feature values where the decision can change.
+   *
+   * \param rss Filled with the RSS split thresholds.
+   * \param pdr Filled with the PDR split thresholds.
+   * \returns True if the label is constant between consecutive thresholds
+   * of both features, as for tree models. Default returns false.
+   */
+  virtual bool GetSplitThresholds (std::vector<double> &rss,
+                                   std::vector<double> &pdr) const;
+
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_CLASSIFIER_H */
@@ -0,0 +1,356 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Scores a feature file written by jamming-preprocess with an exported
+ * model, and reports accuracy, confusion matrix and throughput.
+ *
+ * Usage:
+ *   jamming-classify --model=forest.model --input=features.txt
+ *   jamming-classify --train=train.txt --k=35 --input=features.txt
+ *
+ * Options:
+ *   --model=FILE      model written by export-jamming-model.py
+ *   --train=FILE      training samples of a k nearest neighbors classifier,
+ *                     instead of a model
+ *   --k=N             neighbors of the k nearest neighbors classifier
+ *                     (default 35)
+ *   --input=FILE      "rss pdr label" lines, features already scaled
+ *   --lut=N           answer through an N x N LookupTableClassifier, and
+ *                     report how often it disagrees with the exact model
+ *   --lut-probes=N    rasterize models without split thresholds (k nearest
+ *                     neighbors) by probing N x N points per cell; this is
+ *                     approximate (default 0, those models bypass the table)
+ *   --repeat=N        classify the input N times for timing (default 1)
+ *   --threads=N       classify batches on N threads (default 1)
+ *   --expected=FILE   one label per input line, as predicted by the
+ *                     reference model (export_predictions in
+ *                     export-jamming-model.py); report the samples labeled
+ *                     differently and exit with status 2 if there are any
+ */
+
+#include "random-forest-classifier.h"
+#include "lookup-table-classifier.h"
+#include "nearest-neighbors-classifier.h"
+#include "jamming-tool-options.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " (--model=FILE | --train=FILE [--k=N])"
+            << " --input=FILE [--lut=N [--lut-probes=N]] [--repeat=N]"
+            << " [--threads=N] [--expected=FILE]" << std::endl;
+}
+
+/**
+ * \brief Classifies features in one contiguous batch per thread.
+ */
+void
+ClassifyParallel (Ptr<JammingClassifier> classifier,
+                  std::vector<JammingFeature> const &features,
+                  std::vector<uint8_t> &labels, uint32_t threads)
+{
+  std::vector<std::thread> workers;
+  uint32_t n = features.size ();
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      uint32_t begin = uint64_t (n) * t / threads;
+      uint32_t end = uint64_t (n) * (t + 1) / threads;
+      if (begin == end)
+        {
+          continue;
+        }
+      workers.push_back (std::thread ([&, begin, end] ()
+        {
+          classifier->ClassifyBatch (&features[begin], &labels[begin],
+                                     end - begin);
+        }));
+    }
+  for (uint32_t t = 0; t < workers.size (); t++)
+    {
+      workers[t].join ();
+    }
+}
+
+/**
+ * Walks the model node by node, for kinds without a dedicated classifier.
+ */
+class TreeEnsembleClassifier : public JammingClassifier
+{
+public:
+  TreeEnsembleClassifier (TreeEnsembleModel const &model)
+    : m_model (model)
+  {
+  }
+
+  virtual JammerType Classify (const JammingFeature &feature) const
+  {
+    double x[2] = { feature.rss, feature.pdr };
+    return static_cast<JammerType> (m_model.Predict (x));
+  }
+
+  virtual bool GetSplitThresholds (std::vector<double> &rss,
+                                   std::vector<double> &pdr) const
+  {
+    rss.clear ();
+    pdr.clear ();
+    for (uint32_t t = 0; t < m_model.trees.size (); t++)
+      {
+        const std::vector<TreeNode> &nodes = m_model.trees[t].nodes;
+        for (uint32_t n = 0; n < nodes.size (); n++)
+          {
+            if (nodes[n].feature >= 0)
+              {
+                (nodes[n].feature == 0 ? rss : pdr).push_back (
+                  nodes[n].threshold);
+              }
+          }
+      }
+    return true;
+  }
+
+private:
+  TreeEnsembleModel m_model;
+};
+
+/**
+ * \returns Classifier for the model file, NULL on error.
+ */
+Ptr<JammingClassifier>
+LoadClassifier (std::string const &filename, std::string &error)
+{
+  TreeEnsembleModel model;
+  if (!model.Load (filename, error))
+    {
+      return NULL;
+    }
+  if (model.kind == "forest")
+    {
+      Ptr<RandomForestClassifier> forest = Create<RandomForestClassifier> ();
+      if (forest->SetModel (model, error))
+        {
+          return forest;
+        }
+      return NULL;
+    }
+  if (model.kind == "boosting")
+    {
+      if (model.features != 2 || model.classes > JAMMER_TYPE_COUNT)
+        {
+          error = "expected a model over (RSS, PDR)";
+          return NULL;
+        }
+      return Create<TreeEnsembleClassifier> (model);
+    }
+  error = "unsupported model kind " + model.kind;
+  return NULL;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string modelFile, trainFile, input, expectedFile;
+  uint32_t lut = 0;
+  uint32_t lutProbes = 0;
+  uint32_t repeat = 1;
+  uint32_t k = 35;
+  uint32_t threads = 1;
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if (ParseOption (argv[i], "model", modelFile) ||
+          ParseOption (argv[i], "train", trainFile) ||
+          ParseOption (argv[i], "input", input) ||
+          ParseOption (argv[i], "expected", expectedFile))
+        {
+          continue;
+        }
+      if (ParseOption (argv[i], "lut", value))
+        {
+          lut = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "lut-probes", value))
+        {
+          lutProbes = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "repeat", value))
+        {
+          repeat = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "k", value))
+        {
+          k = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "threads", value))
+        {
+          threads = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  if (modelFile.empty () == trainFile.empty () || input.empty () ||
+      repeat == 0 || k == 0 || threads == 0 || lutProbes == 1)
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  Ptr<JammingClassifier> classifier;
+  Ptr<NearestNeighborsClassifier> knn;
+  if (!trainFile.empty ())
+    {
+      std::vector<JammingSample> train;
+      if (!ReadSamples (trainFile, train) || train.empty ())
+        {
+          std::cerr << "Cannot read samples from " << trainFile << std::endl;
+          return 1;
+        }
+      knn = Create<NearestNeighborsClassifier> (train, k);
+      classifier = knn;
+    }
+  else
+    {
+      std::string error;
+      classifier = LoadClassifier (modelFile, error);
+      if (classifier == NULL)
+        {
+          std::cerr << modelFile << ": " << error << std::endl;
+          return 1;
+        }
+    }
+  Ptr<JammingClassifier> exact = classifier;
+  if (lut > 0)
+    {
+      Ptr<LookupTableClassifier> table =
+        Create<LookupTableClassifier> (classifier, lut, lut, lutProbes);
+      std::cerr << "Lookup table: " << 100.0 * table->GetBoundaryFraction ()
+                << "% boundary cells, "
+                << (table->IsExact () ? "exact" : "approximate") << std::endl;
+      classifier = table;
+    }
+
+  std::vector<JammingSample> samples;
+  if (!ReadSamples (input, samples) || samples.empty ())
+    {
+      std::cerr << "Cannot read samples from " << input << std::endl;
+      return 1;
+    }
+  std::vector<JammingFeature> features (samples.size ());
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      features[i] = samples[i].feature;
+    }
+  std::vector<uint8_t> labels (samples.size ());
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now ();
+  for (uint32_t r = 0; r < repeat; r++)
+    {
+      ClassifyParallel (classifier, features, labels, threads);
+    }
+  double seconds = std::chrono::duration<double> (
+      std::chrono::steady_clock::now () - start).count ();
+
+  uint32_t confusion[JAMMER_TYPE_COUNT][JAMMER_TYPE_COUNT] = { { 0 } };
+  uint32_t correct = 0;
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      confusion[samples[i].label][labels[i]]++;
+      correct += samples[i].label == labels[i];
+    }
+
+  std::cout << "Accuracy: " << double (correct) / samples.size () << "\n"
+            << "Confusion matrix (rows: true label, columns: predicted):\n";
+  for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+    {
+      for (uint32_t p = 0; p < JAMMER_TYPE_COUNT; p++)
+        {
+          std::cout << std::setw (8) << confusion[t][p];
+        }
+      std::cout << "\n";
+    }
+  std::cout << "Classified " << uint64_t (samples.size ()) * repeat
+            << " samples in " << seconds * 1e3 << " ms ("
+            << uint64_t (samples.size ()) * repeat / seconds << " /s)"
+            << std::endl;
+  if (lut > 0)
+    {
+      std::vector<uint8_t> exactLabels (samples.size ());
+      exact->ClassifyBatch (&features[0], &exactLabels[0], features.size ());
+      uint32_t disagree = 0;
+      for (uint32_t i = 0; i < samples.size (); i++)
+        {
+          disagree += labels[i] != exactLabels[i];
+        }
+      std::cout << "Lookup table disagrees with the exact model on "
+                << disagree << " of " << samples.size () << " samples"
+                << std::endl;
+    }
+  if (knn != NULL)
+    {
+      uint64_t distances = 0;
+      std::vector<NearestNeighborsClassifier::Neighbor> neighbors;
+      for (uint32_t i = 0; i < features.size (); i++)
+        {
+          distances += knn->FindNeighbors (features[i], knn->GetK (),
+                                           neighbors);
+        }
+      std::cout << "Distances per query: "
+                << double (distances) / features.size ()
+                << " (brute force " << knn->GetSampleCount () << ")"
+                << std::endl;
+    }
+  if (!expectedFile.empty ())
+    {
+      std::ifstream file (expectedFile.c_str ());
+      uint32_t differ = 0;
+      uint32_t i = 0;
+      int expected;
+      for (; i < samples.size () && file >> expected; i++)
+        {
+          differ += labels[i] != expected;
+        }
+      if (i < samples.size () || file >> expected)
+        {
+          std::cerr << expectedFile << ": expected one label per sample"
+                    << std::endl;
+          return 1;
+        }
+      std::cout << "Differs from " << expectedFile << " on " << differ
+                << " of " << samples.size () << " samples" << std::endl;
+      if (differ > 0)
+        {
+          return 2;
+        }
+    }
+  return 0;
+}
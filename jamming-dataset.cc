@@ -0,0 +1,538 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-dataset.h"
+#include "jamming-trace-file.h"
+#include "jamming-series-file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+const uint32_t CHUNK_SIZE = 4096;   // values converted per batch
+
+/**
+ * \returns Bit pattern of value, with -0.0 folded onto 0.0.
+ */
+uint64_t
+DoubleBits (double value)
+{
+  if (value == 0.0)
+    {
+      value = 0.0;
+    }
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  return bits;
+}
+
+uint64_t
+HashFeature (const JammingFeature &feature)
+{
+  uint64_t h = DoubleBits (feature.rss) * 0x9e3779b97f4a7c15ULL;
+  h ^= DoubleBits (feature.pdr) + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Chunked reader for files holding one number per line.
+ */
+class ValueReader
+{
+public:
+  ValueReader (std::string const &filename)
+    : m_file (std::fopen (filename.c_str (), "r")),
+      m_begin (0),
+      m_end (0),
+      m_fail (m_file == NULL)
+  {
+    m_buffer.resize (1 << 16);
+  }
+
+  /**
+   * Reads from memory. The data must outlive the reader.
+   */
+  ValueReader (const char *data, size_t size)
+    // fmemopen rejects empty buffers, an empty temporary file reads the same
+    : m_file (size == 0 ? std::tmpfile ()
+              : fmemopen (const_cast<char *> (data), size, "r")),
+      m_begin (0),
+      m_end (0),
+      m_fail (m_file == NULL)
+  {
+    m_buffer.resize (1 << 16);
+  }
+
+  ~ValueReader ()
+  {
+    if (m_file != NULL)
+      {
+        std::fclose (m_file);
+      }
+  }
+
+  bool Fail (void) const
+  {
+    return m_fail;
+  }
+
+  /**
+   * \returns Number of values read into out, 0 at end of file.
+   */
+  uint32_t Read (double *out, uint32_t n)
+  {
+    uint32_t count = 0;
+    while (count < n && !m_fail)
+      {
+        const char *line;
+        uint32_t length;
+        if (!NextLine (line, length))
+          {
+            break;
+          }
+        if (length == 0)
+          {
+            continue;   // blank line
+          }
+        // the buffer is always NUL terminated, and strtod stops at '\n'
+        char *end;
+        out[count] = std::strtod (line, &end);
+        if (end == line || end > line + length)
+          {
+            m_fail = true;
+            break;
+          }
+        count++;
+      }
+    return count;
+  }
+
+private:
+  bool NextLine (const char *&line, uint32_t &length)
+  {
+    while (true)
+      {
+        char *newline = static_cast<char *> (
+            std::memchr (&m_buffer[m_begin], '\n', m_end - m_begin));
+        if (newline != NULL)
+          {
+            line = &m_buffer[m_begin];
+            length = newline - line;
+            m_begin += length + 1;
+            return true;
+          }
+        // move partial line to the front and refill
+        uint32_t rest = m_end - m_begin;
+        std::memmove (&m_buffer[0], &m_buffer[m_begin], rest);
+        m_begin = 0;
+        m_end = rest;
+        if (m_end + 1 == m_buffer.size ())
+          {
+            m_buffer.resize (m_buffer.size () * 2);
+          }
+        // keep one byte for the terminating NUL
+        size_t got = std::fread (&m_buffer[m_end], 1,
+                                 m_buffer.size () - m_end - 1, m_file);
+        m_buffer[m_end + got] = '\0';
+        if (got == 0)
+          {
+            if (rest == 0)
+              {
+                return false;
+              }
+            // last line without newline
+            line = &m_buffer[0];
+            length = rest;
+            m_begin = m_end;
+            m_buffer[m_end] = '\0';
+            return true;
+          }
+        m_end += got;
+      }
+  }
+
+private:
+  std::FILE *m_file;
+  std::vector<char> m_buffer;
+  uint32_t m_begin;
+  uint32_t m_end;
+  bool m_fail;
+};
+
+} // anonymous namespace
+
+void
+WattsToDbm (const double *watts, double *dbm, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      dbm[i] = 10.0 * std::log10 (1000.0 * watts[i]);
+    }
+}
+
+/*
+ * JammingFeatureFilter
+ */
+
+const double JammingFeatureFilter::DEFAULT_RSS_FLOOR = -93.5;
+
+JammingFeatureFilter::JammingFeatureFilter (double rssFloorDbm)
+  : m_rssFloor (rssFloorDbm),
+    m_inputCount (0)
+{
+  m_slots.resize (1024, 0);
+  m_dbm.resize (CHUNK_SIZE);
+}
+
+JammingFeatureFilter::~JammingFeatureFilter ()
+{
+}
+
+void
+JammingFeatureFilter::Add (const double *rssWatts, const double *pdr,
+                           uint32_t n)
+{
+  m_inputCount += n;
+  while (n > 0)
+    {
+      uint32_t chunk = n < CHUNK_SIZE ? n : CHUNK_SIZE;
+      WattsToDbm (rssWatts, &m_dbm[0], chunk);
+      for (uint32_t i = 0; i < chunk; i++)
+        {
+          JammingFeature feature;
+          feature.rss = m_dbm[i];
+          feature.pdr = pdr[i];
+          // NaN compares false, so this also drops NaN RSS values
+          if (!(feature.rss >= m_rssFloor) || std::isnan (feature.pdr))
+            {
+              continue;
+            }
+          Insert (feature);
+        }
+      rssWatts += chunk;
+      pdr += chunk;
+      n -= chunk;
+    }
+}
+
+const std::vector<JammingFeature> &
+JammingFeatureFilter::GetFeatures (void) const
+{
+  return m_features;
+}
+
+uint64_t
+JammingFeatureFilter::GetInputCount (void) const
+{
+  return m_inputCount;
+}
+
+void
+JammingFeatureFilter::Clear (void)
+{
+  m_features.clear ();
+  m_slots.assign (1024, 0);
+  m_inputCount = 0;
+}
+
+bool
+JammingFeatureFilter::Insert (const JammingFeature &feature)
+{
+  uint64_t mask = m_slots.size () - 1;
+  uint64_t slot = HashFeature (feature) & mask;
+  while (m_slots[slot] != 0)
+    {
+      const JammingFeature &other = m_features[m_slots[slot] - 1];
+      if (DoubleBits (other.rss) == DoubleBits (feature.rss) &&
+          DoubleBits (other.pdr) == DoubleBits (feature.pdr))
+        {
+          return false; // duplicate
+        }
+      slot = (slot + 1) & mask;
+    }
+  m_features.push_back (feature);
+  m_slots[slot] = m_features.size ();
+  if (2 * m_features.size () > m_slots.size ())
+    {
+      Grow ();    // keep load factor under 1/2
+    }
+  return true;
+}
+
+void
+JammingFeatureFilter::Grow (void)
+{
+  m_slots.assign (m_slots.size () * 2, 0);
+  uint64_t mask = m_slots.size () - 1;
+  for (uint32_t i = 0; i < m_features.size (); i++)
+    {
+      uint64_t slot = HashFeature (m_features[i]) & mask;
+      while (m_slots[slot] != 0)
+        {
+          slot = (slot + 1) & mask;
+        }
+      m_slots[slot] = i + 1;
+    }
+}
+
+/*
+ * JammingFeatureScaler
+ */
+
+JammingFeatureScaler::JammingFeatureScaler ()
+{
+  SetRange (0.0, 1.0, 0.0, 1.0);
+}
+
+void
+JammingFeatureScaler::Fit (const std::vector<JammingFeature> &features)
+{
+  if (features.empty ())
+    {
+      SetRange (0.0, 1.0, 0.0, 1.0);
+      return;
+    }
+  double rssMin = features[0].rss, rssMax = features[0].rss;
+  double pdrMin = features[0].pdr, pdrMax = features[0].pdr;
+  for (uint32_t i = 1; i < features.size (); i++)
+    {
+      rssMin = std::min (rssMin, features[i].rss);
+      rssMax = std::max (rssMax, features[i].rss);
+      pdrMin = std::min (pdrMin, features[i].pdr);
+      pdrMax = std::max (pdrMax, features[i].pdr);
+    }
+  SetRange (rssMin, rssMax, pdrMin, pdrMax);
+}
+
+void
+JammingFeatureScaler::SetRange (double rssMin, double rssMax, double pdrMin,
+                                double pdrMax)
+{
+  m_rssMin = rssMin;
+  m_rssMax = rssMax;
+  m_pdrMin = pdrMin;
+  m_pdrMax = pdrMax;
+  // sklearn maps a constant feature to 0
+  m_rssScale = rssMax > rssMin ? 1.0 / (rssMax - rssMin) : 1.0;
+  m_pdrScale = pdrMax > pdrMin ? 1.0 / (pdrMax - pdrMin) : 1.0;
+}
+
+JammingFeature
+JammingFeatureScaler::Transform (const JammingFeature &feature) const
+{
+  JammingFeature scaled;
+  scaled.rss = (feature.rss - m_rssMin) * m_rssScale;
+  scaled.pdr = (feature.pdr - m_pdrMin) * m_pdrScale;
+  return scaled;
+}
+
+void
+JammingFeatureScaler::Transform (std::vector<JammingFeature> &features) const
+{
+  for (uint32_t i = 0; i < features.size (); i++)
+    {
+      features[i] = Transform (features[i]);
+    }
+}
+
+double
+JammingFeatureScaler::GetRssMin (void) const
+{
+  return m_rssMin;
+}
+
+double
+JammingFeatureScaler::GetRssMax (void) const
+{
+  return m_rssMax;
+}
+
+double
+JammingFeatureScaler::GetPdrMin (void) const
+{
+  return m_pdrMin;
+}
+
+double
+JammingFeatureScaler::GetPdrMax (void) const
+{
+  return m_pdrMax;
+}
+
+/*
+ * File helpers
+ */
+
+namespace {
+
+bool
+ReadValuePair (ValueReader &rssReader, ValueReader &pdrReader,
+               JammingFeatureFilter &filter)
+{
+  std::vector<double> rss (CHUNK_SIZE), pdr (CHUNK_SIZE);
+  while (!rssReader.Fail () && !pdrReader.Fail ())
+    {
+      uint32_t nRss = rssReader.Read (&rss[0], CHUNK_SIZE);
+      uint32_t nPdr = pdrReader.Read (&pdr[0], CHUNK_SIZE);
+      if (nRss != nPdr)
+        {
+          return false; // files differ in length
+        }
+      if (nRss == 0)
+        {
+          return true;
+        }
+      filter.Add (&rss[0], &pdr[0], nRss);
+    }
+  return false;
+}
+
+} // anonymous namespace
+
+bool
+ReadTextPair (std::string const &rssFile, std::string const &pdrFile,
+              JammingFeatureFilter &filter)
+{
+  ValueReader rssReader (rssFile);
+  ValueReader pdrReader (pdrFile);
+  return ReadValuePair (rssReader, pdrReader, filter);
+}
+
+bool
+ReadStoredPair (const JammingChunkStore &store, const JammingChunkKey &rssKey,
+                const JammingChunkKey &pdrKey, JammingFeatureFilter &filter)
+{
+  std::string rssData, pdrData;
+  if (!store.Get (rssKey, rssData) || !store.Get (pdrKey, pdrData))
+    {
+      return false;
+    }
+  ValueReader rssReader (rssData.data (), rssData.size ());
+  ValueReader pdrReader (pdrData.data (), pdrData.size ());
+  return ReadValuePair (rssReader, pdrReader, filter);
+}
+
+bool
+ReadSeries (std::string const &seriesFile, JammingFeatureFilter &filter)
+{
+  JammingSeriesFile series;
+  series.Open (seriesFile, std::ios::in);
+  std::vector<double> rss (CHUNK_SIZE), pdr (CHUNK_SIZE);
+  uint32_t n;
+  while ((n = series.Read (&rss[0], &pdr[0], CHUNK_SIZE)) > 0)
+    {
+      filter.Add (&rss[0], &pdr[0], n);
+    }
+  return !series.Fail ();
+}
+
+bool
+ReadTrace (std::string const &traceFile,
+           std::vector<JammingFeatureFilter> &filters)
+{
+  JammingTraceView view;
+  if (!view.Open (traceFile))
+    {
+      return false;
+    }
+  if (filters.size () < JAMMER_TYPE_COUNT)
+    {
+      filters.resize (JAMMER_TYPE_COUNT);
+    }
+  std::vector<double> rss[JAMMER_TYPE_COUNT], pdr[JAMMER_TYPE_COUNT];
+  for (uint32_t b = 0; b < view.GetBlockCount (); b++)
+    {
+      const JammingTraceView::Block &block = view.GetBlock (b);
+      // split block by jammer type; a block usually holds a single type
+      for (uint32_t i = 0; i < block.rows; i++)
+        {
+          uint8_t type = block.jammerType[i];
+          if (type >= JAMMER_TYPE_COUNT)
+            {
+              return false;
+            }
+          rss[type].push_back (block.rss[i]);
+          pdr[type].push_back (block.pdr[i]);
+        }
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          if (!rss[t].empty ())
+            {
+              filters[t].Add (&rss[t][0], &pdr[t][0], rss[t].size ());
+              rss[t].clear ();
+              pdr[t].clear ();
+            }
+        }
+    }
+  return true;
+}
+
+void
+WriteSamples (std::ostream &os, const std::vector<JammingSample> &samples)
+{
+  std::ostringstream line;
+  line << std::setprecision (std::numeric_limits<double>::digits10 + 2);
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      line.str ("");
+      line << samples[i].feature.rss << " " << samples[i].feature.pdr << " "
+           << uint32_t (samples[i].label) << "\n";
+      os << line.str ();
+    }
+}
+
+bool
+ReadSamples (std::string const &filename, std::vector<JammingSample> &samples)
+{
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (file, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream is (line);
+      JammingSample sample;
+      uint32_t label;
+      if (!(is >> sample.feature.rss >> sample.feature.pdr >> label) ||
+          label >= JAMMER_TYPE_COUNT)
+        {
+          return false;
+        }
+      sample.label = label;
+      samples.push_back (sample);
+    }
+  return true;
+}
+
+} // namespace ns3
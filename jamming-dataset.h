@@ -0,0 +1,226 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_DATASET_H
+#define JAMMING_DATASET_H
+
+#include "jammer-type.h"
+#include "jamming-chunk-store.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * One (RSS, PDR) feature pair. RSS is in dBm once it went through
+ * JammingFeatureFilter, or min-max scaled once it went through
+ * JammingFeatureScaler.
+ */
+struct JammingFeature
+{
+  double rss;
+  double pdr;
+};
+
+/**
+ * A labelled feature, one row of a training set.
+ */
+struct JammingSample
+{
+  JammingFeature feature;
+  uint8_t label;        // JammerType
+};
+
+/**
+ * \brief Converts RSS values from Watts to dBm, ie. 10 * log10 (1000 * w).
+ *
+ * \param watts Input array.
+ * \param dbm Output array, may alias the input.
+ * \param n Number of values.
+ *
+ * The loop body has no branches, so it is vectorized by the compiler where a
+ * vector log10 is available.
+ */
+void WattsToDbm (const double *watts, double *dbm, uint32_t n);
+
+/**
+ * \brief Streaming cleanup of raw (RSS, PDR) pairs.
+ *
+ * Does in one pass what classification.ipynb does with delNaN, unique_rows
+ * and the -93.5 dBm sentinel rewrite:
+ *  - converts RSS from Watts to dBm,
+ *  - drops pairs with a NaN on either side,
+ *  - drops pairs below the RSS floor (the notebook rewrites them into a
+ *    single (-84, 2) sentinel row and then deletes that row),
+ *  - drops duplicate pairs, using a hash set instead of sorting.
+ *
+ * Unique pairs are kept in order of first appearance.
+ */
+class JammingFeatureFilter
+{
+public:
+  static const double DEFAULT_RSS_FLOOR;    // -93.5 dBm
+
+  JammingFeatureFilter (double rssFloorDbm = DEFAULT_RSS_FLOOR);
+  ~JammingFeatureFilter ();
+
+  /**
+   * \brief Feeds a chunk of raw pairs.
+   *
+   * \param rssWatts RSS values in Watts.
+   * \param pdr PDR values.
+   * \param n Number of pairs.
+   */
+  void Add (const double *rssWatts, const double *pdr, uint32_t n);
+
+  /**
+   * \returns Unique, valid features seen so far (RSS in dBm).
+   */
+  const std::vector<JammingFeature> & GetFeatures (void) const;
+
+  /**
+   * \returns Number of raw pairs fed.
+   */
+  uint64_t GetInputCount (void) const;
+
+  /**
+   * Drops all features and counters.
+   */
+  void Clear (void);
+
+private:
+  /**
+   * Open addressing hash set of feature indices.
+   */
+  bool Insert (const JammingFeature &feature);
+  void Grow (void);
+
+private:
+  double m_rssFloor;
+  std::vector<JammingFeature> m_features;
+  std::vector<uint32_t> m_slots;    // index + 1 into m_features, 0 if empty
+  std::vector<double> m_dbm;        // conversion scratch buffer
+  uint64_t m_inputCount;
+
+};
+
+/**
+ * \brief Min-max scaler over the two features, as sklearn's MinMaxScaler.
+ */
+class JammingFeatureScaler
+{
+public:
+  JammingFeatureScaler ();
+
+  /**
+   * \brief Fits scaler to features.
+   */
+  void Fit (const std::vector<JammingFeature> &features);
+
+  /**
+   * \brief Sets scaler range directly.
+   */
+  void SetRange (double rssMin, double rssMax, double pdrMin, double pdrMax);
+
+  /**
+   * \returns Scaled copy of feature.
+   */
+  JammingFeature Transform (const JammingFeature &feature) const;
+
+  /**
+   * \brief Scales features in place.
+   */
+  void Transform (std::vector<JammingFeature> &features) const;
+
+  double GetRssMin (void) const;
+  double GetRssMax (void) const;
+  double GetPdrMin (void) const;
+  double GetPdrMax (void) const;
+
+private:
+  double m_rssMin;
+  double m_rssScale;    // 1 / (max - min), 1 for a constant feature
+  double m_rssMax;
+  double m_pdrMin;
+  double m_pdrScale;
+  double m_pdrMax;
+
+};
+
+/**
+ * \brief Reads a rss_*.txt / pdr_*.txt pair and feeds it to a filter.
+ *
+ * \param rssFile Name of RSS file (one value in Watts per line).
+ * \param pdrFile Name of PDR file (one value per line).
+ * \param filter Filter to feed.
+ * \returns False if a file cannot be read or the files differ in length.
+ *
+ * Files are read in chunks, so memory use depends only on the number of
+ * unique pairs.
+ */
+bool ReadTextPair (std::string const &rssFile, std::string const &pdrFile,
+                   JammingFeatureFilter &filter);
+
+/**
+ * \brief Reads a RSS / PDR file pair from a JammingChunkStore and feeds it
+ * to a filter.
+ *
+ * \returns False if a file is not in the store or the files differ in
+ * length.
+ */
+bool ReadStoredPair (const JammingChunkStore &store,
+                     const JammingChunkKey &rssKey,
+                     const JammingChunkKey &pdrKey,
+                     JammingFeatureFilter &filter);
+
+/**
+ * \brief Reads a JammingSeriesFile and feeds it to a filter.
+ *
+ * \param seriesFile Name of series file.
+ * \param filter Filter to feed.
+ * \returns False if the file cannot be read.
+ */
+bool ReadSeries (std::string const &seriesFile, JammingFeatureFilter &filter);
+
+/**
+ * \brief Reads a JammingTraceFile and feeds each jammer type to its filter.
+ *
+ * \param traceFile Name of trace file.
+ * \param filters One filter per JammerType, indexed by type.
+ * \returns False if the trace cannot be read.
+ */
+bool ReadTrace (std::string const &traceFile,
+                std::vector<JammingFeatureFilter> &filters);
+
+/**
+ * \brief Writes samples as "rss pdr label" lines, loadable by np.loadtxt.
+ */
+void WriteSamples (std::ostream &os, const std::vector<JammingSample> &samples);
+
+/**
+ * \brief Reads samples written by WriteSamples. Lines starting with '#' are
+ * skipped.
+ *
+ * \returns False if the file cannot be read or has a malformed line.
+ */
+bool ReadSamples (std::string const &filename,
+                  std::vector<JammingSample> &samples);
+
+} // namespace ns3
+
+#endif /* JAMMING_DATASET_H */
@@ -0,0 +1,276 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-detector.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("JammingDetector");
+
+/*
+ * Jamming Detector
+ */
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (JammingDetector);
+
+TypeId
+JammingDetector::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::JammingDetector")
+    .SetParent<Object> ()
+    .AddConstructor<JammingDetector> ()
+    .AddAttribute ("WindowSize",
+                   "Number of packets classified before a label is emitted.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&JammingDetector::SetWindowSize,
+                                         &JammingDetector::GetWindowSize),
+                   MakeUintegerChecker<uint32_t> (1, 0xffffffff))
+    .AddAttribute ("RssFloor",
+                   "Packets received below this RSS, in dBm, are skipped.",
+                   DoubleValue (JammingFeatureFilter::DEFAULT_RSS_FLOOR),
+                   MakeDoubleAccessor (&JammingDetector::SetRssFloor,
+                                       &JammingDetector::GetRssFloor),
+                   MakeDoubleChecker<double> ())
+    .AddTraceSource ("Detection",
+                     "Label, mean RSS (dBm) and mean PDR of a completed window.",
+                     MakeTraceSourceAccessor (&JammingDetector::m_detectionTrace))
+  ;
+  return tid;
+}
+
+JammingDetector::JammingDetector ()
+  : m_scalerSet (false),
+    m_windowSize (100),
+    m_rssFloor (JammingFeatureFilter::DEFAULT_RSS_FLOOR)
+{
+  Reset ();
+}
+
+JammingDetector::~JammingDetector ()
+{
+}
+
+void
+JammingDetector::SetUtility (Ptr<WirelessModuleUtility> utility)
+{
+  NS_LOG_FUNCTION (this << utility);
+  NS_ASSERT (utility != NULL);
+  m_utility = utility;
+  m_utility->SetEndRxCallback (MakeCallback (&JammingDetector::EndRxHandler,
+                                             this));
+}
+
+void
+JammingDetector::SetClassifier (Ptr<JammingClassifier> classifier)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (classifier != NULL);
+  m_classifier = classifier;
+}
+
+Ptr<JammingClassifier>
+JammingDetector::GetClassifier (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_classifier;
+}
+
+void
+JammingDetector::SetScaler (const JammingFeatureScaler &scaler)
+{
+  NS_LOG_FUNCTION (this);
+  m_scaler = scaler;
+  m_scalerSet = true;
+}
+
+void
+JammingDetector::SetWindowSize (uint32_t packets)
+{
+  NS_LOG_FUNCTION (this << packets);
+  NS_ASSERT (packets > 0);
+  m_windowSize = packets;
+}
+
+uint32_t
+JammingDetector::GetWindowSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_windowSize;
+}
+
+void
+JammingDetector::SetRssFloor (double rssFloorDbm)
+{
+  NS_LOG_FUNCTION (this << rssFloorDbm);
+  m_rssFloor = rssFloorDbm;
+}
+
+double
+JammingDetector::GetRssFloor (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rssFloor;
+}
+
+void
+JammingDetector::NotifyRx (double rss, double pdr)
+{
+  NS_LOG_FUNCTION (this << rss << pdr);
+  NS_ASSERT_MSG (m_classifier != NULL, "JammingDetector: No classifier set");
+  NS_ASSERT_MSG (m_scalerSet, "JammingDetector: No scaler set");
+
+  JammingFeature feature;
+  WattsToDbm (&rss, &feature.rss, 1);
+  feature.pdr = pdr;
+  // same filtering as the training data
+  if (!(feature.rss >= m_rssFloor) || std::isnan (pdr))
+    {
+      NS_LOG_DEBUG ("JammingDetector: Skipping packet with RSS = " <<
+                    feature.rss << " dBm, PDR = " << pdr);
+      return;
+    }
+
+  // Welford update of window statistics
+  m_count++;
+  double delta = feature.rss - m_rssMean;
+  m_rssMean += delta / m_count;
+  m_rssM2 += delta * (feature.rss - m_rssMean);
+  m_pdrMean += (pdr - m_pdrMean) / m_count;
+
+  m_votes[m_classifier->Classify (m_scaler.Transform (feature))]++;
+
+  if (m_count == m_windowSize)
+    {
+      CloseWindow ();
+    }
+}
+
+void
+JammingDetector::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_count = 0;
+  m_rssMean = 0.0;
+  m_rssM2 = 0.0;
+  m_pdrMean = 0.0;
+  for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+    {
+      m_votes[t] = 0;
+    }
+  m_lastLabel = NO_JAMMER;
+  m_firstDetection = Seconds (-1.0);
+}
+
+JammerType
+JammingDetector::GetLastLabel (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_lastLabel;
+}
+
+Time
+JammingDetector::GetFirstDetectionTime (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_firstDetection;
+}
+
+double
+JammingDetector::GetMeanRss (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rssMean;
+}
+
+double
+JammingDetector::GetRssVariance (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_count > 1 ? m_rssM2 / (m_count - 1) : 0.0;
+}
+
+double
+JammingDetector::GetMeanPdr (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_pdrMean;
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+JammingDetector::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_utility = NULL;
+  m_classifier = NULL;
+}
+
+bool
+JammingDetector::EndRxHandler (Ptr<Packet> packet, double averageRss)
+{
+  NS_LOG_FUNCTION (this << packet << averageRss);
+  NS_ASSERT (m_utility != NULL);
+  NotifyRx (averageRss, m_utility->GetPdr ());
+  return false;
+}
+
+void
+JammingDetector::CloseWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // majority vote, ties go to the lowest label
+  uint32_t best = 0;
+  for (uint32_t t = 1; t < JAMMER_TYPE_COUNT; t++)
+    {
+      if (m_votes[t] > m_votes[best])
+        {
+          best = t;
+        }
+    }
+  m_lastLabel = JammerType (best);
+  if (m_lastLabel != NO_JAMMER && m_firstDetection.IsStrictlyNegative ())
+    {
+      m_firstDetection = Simulator::Now ();
+    }
+
+  NS_LOG_DEBUG ("JammingDetector: Window labelled " <<
+                JammerTypeToString (m_lastLabel) << ", mean RSS = " <<
+                m_rssMean << " dBm, mean PDR = " << m_pdrMean << ", At " <<
+                Simulator::Now ().GetSeconds () << "s");
+  m_detectionTrace (m_lastLabel, m_rssMean, m_pdrMean);
+
+  // start next window, keeping the detection history
+  m_count = 0;
+  m_rssMean = 0.0;
+  m_rssM2 = 0.0;
+  m_pdrMean = 0.0;
+  for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+    {
+      m_votes[t] = 0;
+    }
+}
+
+} // namespace ns3
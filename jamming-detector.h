@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_DETECTOR_H
+#define JAMMING_DETECTOR_H
+
+#include "jamming-classifier.h"
+#include "wireless-module-utility.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \brief Online jamming detector.
+ *
+ * Installed on a receiving node next to the jammers. Every received packet
+ * gives one (RSS, PDR) feature; it is scaled and classified as in
+ * classification.ipynb, and the running RSS / PDR statistics of the window
+ * are updated. Every WindowSize packets the majority label of the window is
+ * reported through the "Detection" trace source, so detection latency can be
+ * measured in simulation time.
+ *
+ * There is no default model: SetClassifier and SetScaler must be called
+ * before the first packet is received.
+ */
+class JammingDetector : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  JammingDetector ();
+  virtual ~JammingDetector ();
+
+  /**
+   * \brief Sets pointer to WirelessModuleUtility installed on node, and
+   * hooks the end RX event of the utility.
+   *
+   * \param utility Pointer to WirelessModuleUtility.
+   *
+   * Do not use on a node where a jammer or a mitigation module already owns
+   * the utility callbacks; feed NotifyRx from that module instead.
+   */
+  void SetUtility (Ptr<WirelessModuleUtility> utility);
+
+  /**
+   * \brief Sets the model used to classify features.
+   *
+   * \param classifier Classifier over scaled (RSS, PDR) features.
+   */
+  void SetClassifier (Ptr<JammingClassifier> classifier);
+  Ptr<JammingClassifier> GetClassifier (void) const;
+
+  /**
+   * \brief Sets the scaler applied to features before classification.
+   *
+   * \param scaler Scaler fitted on the training data.
+   */
+  void SetScaler (const JammingFeatureScaler &scaler);
+
+  /**
+   * \brief Feeds one received packet to the detector.
+   *
+   * \param rss RSS of packet, in Watts.
+   * \param pdr PDR seen by the node.
+   */
+  void NotifyRx (double rss, double pdr);
+
+  /**
+   * Clears the current window and the detection history.
+   */
+  void Reset (void);
+
+  // setter & getters of attributes
+  void SetWindowSize (uint32_t packets);
+  uint32_t GetWindowSize (void) const;
+  void SetRssFloor (double rssFloorDbm);
+  double GetRssFloor (void) const;
+
+  /**
+   * \returns Label of the last completed window.
+   */
+  JammerType GetLastLabel (void) const;
+
+  /**
+   * \returns Time the first window was labelled as jammed, or a negative
+   * time if no jamming was detected yet.
+   */
+  Time GetFirstDetectionTime (void) const;
+
+  /**
+   * \returns Mean RSS of the current window, in dBm.
+   */
+  double GetMeanRss (void) const;
+
+  /**
+   * \returns Variance of RSS of the current window, in dBm^2.
+   */
+  double GetRssVariance (void) const;
+
+  /**
+   * \returns Mean PDR of the current window.
+   */
+  double GetMeanPdr (void) const;
+
+private:
+  void DoDispose (void);
+
+  /**
+   * \brief Handles end RX event of the utility.
+   *
+   * \param packet Pointer to incoming packet.
+   * \param averageRss Average RSS of packet.
+   * \returns False, the detector never consumes packets.
+   */
+  bool EndRxHandler (Ptr<Packet> packet, double averageRss);
+
+  /**
+   * Labels the window that just completed and starts a new one.
+   */
+  void CloseWindow (void);
+
+private:
+  Ptr<WirelessModuleUtility> m_utility;
+  Ptr<JammingClassifier> m_classifier;
+  JammingFeatureScaler m_scaler;
+  bool m_scalerSet;           // SetScaler was called
+  uint32_t m_windowSize;      // packets per window
+  double m_rssFloor;          // packets below this RSS (dBm) are skipped
+  // running statistics of current window
+  uint32_t m_count;
+  double m_rssMean;
+  double m_rssM2;             // sum of squared deviations (Welford)
+  double m_pdrMean;
+  uint32_t m_votes[JAMMER_TYPE_COUNT];
+  JammerType m_lastLabel;
+  Time m_firstDetection;
+  /**
+   * Fired at the end of each window, with the window label, mean RSS (dBm)
+   * and mean PDR.
+   */
+  TracedCallback<JammerType, double, double> m_detectionTrace;
+
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_DETECTOR_H */
@@ -0,0 +1,471 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Compiles a jamming model into a header of inline code, so a detector can
+ * classify without loading a model file or chasing node pointers.
+ *
+ * Usage:
+ *   jamming-model-codegen --model=boosting.model --name=BoostingModel \
+ *     --output=boosting-model.h
+ *
+ * Options:
+ *   --model=FILE      model written by export-jamming-model.py
+ *   --name=NAME       name of the generated struct (default JammingModel)
+ *   --output=FILE     header to write
+ *   --layout=L        "branches" (default) or "select"
+ *
+ * With layout "branches" every tree becomes an inline function returning
+ * one nested conditional expression (constexpr-friendly, but the module
+ * builds as C++98); short subtrees compile to conditional moves. With
+ * layout "select" trees up to depth 12 are padded to complete trees in
+ * breadth-first arrays and walked with one comparison per level and no
+ * data-dependent branch, which wins on deep trees whose branches the CPU
+ * cannot predict. Forest trees return the index of
+ * their leaf into a table of class probabilities, boosting trees return the
+ * leaf value itself. The generated struct provides
+ *
+ *   static uint32_t Classify (double rss, double pdr);
+ *
+ * over scaled features, with the same predictions as
+ * TreeEnsembleModel::Predict and RandomForestClassifier, and can be wrapped
+ * as a JammingClassifier with GeneratedModelClassifier<NAME>.
+ */
+
+#include "tree-ensemble-model.h"
+#include "jamming-tool-options.h"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --model=FILE --output=FILE"
+            << " [--name=NAME] [--layout=branches|select]" << std::endl;
+}
+
+std::string
+FloatLiteral (float value)
+{
+  if (std::isinf (value))
+    {
+      return value > 0 ? "HUGE_VALF" : "-HUGE_VALF";
+    }
+  char buffer[32];
+  // 9 significant digits round trip a float
+  std::snprintf (buffer, sizeof (buffer), "%.9gf", value);
+  std::string literal = buffer;
+  if (literal.find_first_of (".e") == std::string::npos)
+    {
+      literal.insert (literal.size () - 1, ".0");
+    }
+  return literal;
+}
+
+std::string
+DoubleLiteral (double value)
+{
+  char buffer[32];
+  // 17 significant digits round trip a double
+  std::snprintf (buffer, sizeof (buffer), "%.17g", value);
+  std::string literal = buffer;
+  if (literal.find_first_of (".en") == std::string::npos)
+    {
+      literal += ".0";
+    }
+  return literal;
+}
+
+// deepest tree laid out as a complete tree, 2^depth leaf slots
+const uint32_t MAX_SELECT_DEPTH = 12;
+
+/**
+ * Numbers the leaves below node, left subtree first.
+ */
+void
+NumberLeaves (const DecisionTree &tree, int32_t node,
+              std::vector<int32_t> &leafOrder)
+{
+  const TreeNode &n = tree.nodes[node];
+  if (n.feature < 0)
+    {
+      leafOrder.push_back (node);
+      return;
+    }
+  NumberLeaves (tree, n.left, leafOrder);
+  NumberLeaves (tree, n.right, leafOrder);
+}
+
+/**
+ * Emits a subtree as nested conditional expressions, evaluating to the
+ * leaf value (boosting) or to the leaf number (forest).
+ */
+void
+WriteBranches (std::ostream &os, const DecisionTree &tree, bool boosting,
+               int32_t node, uint32_t depth, uint32_t &leaf)
+{
+  const TreeNode &n = tree.nodes[node];
+  if (n.feature < 0)
+    {
+      if (boosting)
+        {
+          os << DoubleLiteral (tree.values[node]);
+        }
+      else
+        {
+          os << leaf << "u";
+        }
+      leaf++;
+      return;
+    }
+  os << "x" << n.feature << " <= "
+     << FloatLiteral (FloatThresholdBelow (n.threshold))
+     << "\n" << std::string (2 * depth + 4, ' ') << "? ";
+  WriteBranches (os, tree, boosting, n.left, depth + 1, leaf);
+  os << "\n" << std::string (2 * depth + 4, ' ') << ": ";
+  WriteBranches (os, tree, boosting, n.right, depth + 1, leaf);
+}
+
+/**
+ * Lays a subtree out as a complete tree of the given number of levels,
+ * children of position i at 2i + 1 and 2i + 2. A leaf above the bottom
+ * level is pushed down through padding nodes that always go left.
+ *
+ * \param leafNumber Number of the leaf at each node index.
+ * \param leaves Filled with the leaf number of each bottom position.
+ */
+void
+FillComplete (const DecisionTree &tree, int32_t node, uint32_t position,
+              uint32_t levels, std::vector<uint32_t> const &leafNumber,
+              std::vector<uint32_t> &feature, std::vector<float> &threshold,
+              std::vector<uint32_t> &leaves)
+{
+  uint32_t internal = (1u << levels) - 1;
+  if (position >= internal)
+    {
+      leaves[position - internal] = leafNumber[node];
+      return;
+    }
+  const TreeNode &n = tree.nodes[node];
+  if (n.feature < 0)
+    {
+      feature[position] = 0;
+      threshold[position] = std::numeric_limits<float>::infinity ();
+      FillComplete (tree, node, 2 * position + 1, levels, leafNumber,
+                    feature, threshold, leaves);
+      FillComplete (tree, node, 2 * position + 2, levels, leafNumber,
+                    feature, threshold, leaves);
+      return;
+    }
+  feature[position] = n.feature;
+  threshold[position] = FloatThresholdBelow (n.threshold);
+  FillComplete (tree, n.left, 2 * position + 1, levels, leafNumber,
+                feature, threshold, leaves);
+  FillComplete (tree, n.right, 2 * position + 2, levels, leafNumber,
+                feature, threshold, leaves);
+}
+
+template <class T>
+void
+WriteArray (std::ostream &os, const char *type, std::string const &name,
+            std::vector<T> const &values)
+{
+  os << "const " << type << " " << name << "[" << values.size () << "] = {";
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      os << (i % 8 == 0 ? "\n  " : " ") << values[i] << ",";
+    }
+  os << "\n};\n\n";
+}
+
+/**
+ * Emits the function walking a tree laid out by FillComplete. Every level
+ * is one comparison feeding an index computation, so no branch depends on
+ * the features.
+ */
+void
+WriteSelect (std::ostream &os, const DecisionTree &tree, uint32_t index,
+             std::vector<int32_t> const &leafOrder, bool boosting)
+{
+  uint32_t levels = tree.GetDepth ();
+  std::vector<uint32_t> leafNumber (tree.nodes.size ());
+  for (uint32_t l = 0; l < leafOrder.size (); l++)
+    {
+      leafNumber[leafOrder[l]] = l;
+    }
+  std::vector<uint32_t> feature ((1u << levels) - 1);
+  std::vector<float> threshold ((1u << levels) - 1);
+  std::vector<uint32_t> leaves (1u << levels);
+  FillComplete (tree, 0, 0, levels, leafNumber, feature, threshold, leaves);
+
+  std::ostringstream suffix;
+  suffix << index;
+  std::vector<std::string> thresholds (threshold.size ());
+  for (uint32_t i = 0; i < threshold.size (); i++)
+    {
+      thresholds[i] = FloatLiteral (threshold[i]);
+    }
+  if (levels > 0)
+    {
+      WriteArray (os, "uint8_t", "FEATURE" + suffix.str (), feature);
+      WriteArray (os, "float", "THRESHOLD" + suffix.str (), thresholds);
+    }
+  WriteArray (os, "uint16_t", "LEAF_NUMBER" + suffix.str (), leaves);
+  if (boosting)
+    {
+      std::vector<std::string> values (leafOrder.size ());
+      for (uint32_t l = 0; l < leafOrder.size (); l++)
+        {
+          values[l] = DoubleLiteral (tree.values[leafOrder[l]]);
+        }
+      WriteArray (os, "double", "VALUE" + suffix.str (), values);
+    }
+
+  os << "inline " << (boosting ? "double" : "uint32_t") << "\nTree" << index
+     << " (float x0, float x1)\n{\n";
+  if (levels > 0)
+    {
+      os << "  const float x[2] = { x0, x1 };\n"
+         << "  uint32_t i = 0;\n"
+         << "  for (uint32_t level = 0; level < " << levels << "; level++)\n"
+         << "    {\n"
+         << "      i = 2 * i + 2 - (x[FEATURE" << index << "[i]] <= THRESHOLD"
+         << index << "[i]);\n"
+         << "    }\n";
+    }
+  else
+    {
+      os << "  const uint32_t i = 0;\n";
+    }
+  std::ostringstream leaf;
+  leaf << "LEAF_NUMBER" << index << "[i - " << (1u << levels) - 1 << "]";
+  if (boosting)
+    {
+      os << "  return VALUE" << index << "[" << leaf.str () << "];\n}\n\n";
+    }
+  else
+    {
+      os << "  return " << leaf.str () << ";\n}\n\n";
+    }
+}
+
+bool
+IsIdentifier (std::string const &name)
+{
+  if (name.empty () || std::isdigit (static_cast<unsigned char> (name[0])))
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < name.size (); i++)
+    {
+      if (!std::isalnum (static_cast<unsigned char> (name[i])) && name[i] != '_')
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+std::string
+ToUpper (std::string const &name)
+{
+  std::string upper;
+  for (uint32_t i = 0; i < name.size (); i++)
+    {
+      if (std::isupper (static_cast<unsigned char> (name[i])) && i > 0)
+        {
+          upper += '_';
+        }
+      upper += std::toupper (static_cast<unsigned char> (name[i]));
+    }
+  return upper;
+}
+
+void
+Generate (std::ostream &os, const TreeEnsembleModel &model,
+          std::string const &name, std::string const &source, bool select)
+{
+  bool boosting = model.kind == "boosting";
+  uint32_t scores = boosting ? model.GetScoreCount () : model.classes;
+  std::string guard = ToUpper (name) + "_H";
+  std::string detail = name + "Detail";
+
+  os << "// Generated by jamming-model-codegen from " << source
+     << ", do not edit.\n\n"
+     << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+     << "#include <math.h>\n#include <stdint.h>\n\n"
+     << "namespace ns3 {\n\nnamespace " << detail << " {\n\n";
+
+  std::vector<std::vector<int32_t> > leafOrders (model.trees.size ());
+  for (uint32_t t = 0; t < model.trees.size (); t++)
+    {
+      const DecisionTree &tree = model.trees[t];
+      NumberLeaves (tree, 0, leafOrders[t]);
+      if (select && tree.GetDepth () <= MAX_SELECT_DEPTH)
+        {
+          WriteSelect (os, tree, t, leafOrders[t], boosting);
+        }
+      else
+        {
+          uint32_t leaf = 0;
+          os << "inline " << (boosting ? "double" : "uint32_t") << "\nTree"
+             << t << " (float x0, float x1)\n{\n  return ";
+          WriteBranches (os, tree, boosting, 0, 0, leaf);
+          os << ";\n}\n\n";
+        }
+      if (boosting)
+        {
+          continue;
+        }
+      // leaf class probabilities, normalized as sklearn's predict_proba
+      os << "const double LEAF" << t << "[][" << scores << "] = {\n";
+      for (uint32_t l = 0; l < leafOrders[t].size (); l++)
+        {
+          const double *value = &tree.values[leafOrders[t][l] * model.outputs];
+          double sum = 0.0;
+          for (uint32_t c = 0; c < scores; c++)
+            {
+              sum += value[c];
+            }
+          sum = sum == 0.0 ? 1.0 : sum;
+          os << "  {";
+          for (uint32_t c = 0; c < scores; c++)
+            {
+              os << (c > 0 ? ", " : " ") << DoubleLiteral (value[c] / sum);
+            }
+          os << " },\n";
+        }
+      os << "};\n\n";
+    }
+  os << "} // namespace " << detail << "\n\n";
+
+  os << "/**\n * \\brief " << (boosting ? "Gradient boosting" : "Forest")
+     << " model compiled from " << source << ".\n */\n"
+     << "struct " << name << "\n{\n"
+     << "  static const uint32_t CLASSES = " << model.classes << ";\n\n"
+     << "  /**\n   * \\param rss Scaled RSS.\n   * \\param pdr Scaled PDR.\n"
+     << "   * \\returns Predicted class.\n   */\n"
+     << "  static inline uint32_t Classify (double rss, double pdr)\n  {\n"
+     << "    using namespace " << detail << ";\n"
+     << "    const float x0 = static_cast<float> (rss);\n"
+     << "    const float x1 = static_cast<float> (pdr);\n";
+  for (uint32_t k = 0; k < scores; k++)
+    {
+      os << "    double s" << k << " = "
+         << (boosting ? DoubleLiteral (model.init[k]) : "0.0") << ";\n";
+    }
+  for (uint32_t t = 0; t < model.trees.size (); t++)
+    {
+      if (boosting)
+        {
+          os << "    s" << t % scores << " += Tree" << t << " (x0, x1);\n";
+          continue;
+        }
+      os << "    {\n      const double *v = LEAF" << t << "[Tree" << t
+         << " (x0, x1)];\n";
+      for (uint32_t k = 0; k < scores; k++)
+        {
+          os << "      s" << k << " += v[" << k << "];\n";
+        }
+      os << "    }\n";
+    }
+  if (boosting && scores == 1)
+    {
+      os << "    return s0 > 0.0 ? 1 : 0;\n  }\n};\n\n";
+    }
+  else
+    {
+      if (!boosting)
+        {
+          // mean, as RandomForestClassifier, so ties break the same way
+          for (uint32_t k = 0; k < scores; k++)
+            {
+              os << "    s" << k << " /= " << model.trees.size () << ".0;\n";
+            }
+        }
+      os << "    uint32_t best = 0;\n    double bestScore = s0;\n";
+      for (uint32_t k = 1; k < scores; k++)
+        {
+          os << "    if (s" << k << " > bestScore)\n      {\n"
+             << "        best = " << k << ";\n        bestScore = s" << k
+             << ";\n      }\n";
+        }
+      os << "    return best;\n  }\n};\n\n";
+    }
+  os << "} // namespace ns3\n\n#endif /* " << guard << " */\n";
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string modelFile, output, name = "JammingModel", layout = "branches";
+  for (int i = 1; i < argc; i++)
+    {
+      if (!ParseOption (argv[i], "model", modelFile) &&
+          !ParseOption (argv[i], "output", output) &&
+          !ParseOption (argv[i], "name", name) &&
+          !ParseOption (argv[i], "layout", layout))
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  if (modelFile.empty () || output.empty () || !IsIdentifier (name) ||
+      (layout != "branches" && layout != "select"))
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  TreeEnsembleModel model;
+  std::string error;
+  if (!model.Load (modelFile, error))
+    {
+      std::cerr << modelFile << ": " << error << std::endl;
+      return 1;
+    }
+  if (model.features != 2 ||
+      (model.kind == "forest" && model.outputs != model.classes))
+    {
+      std::cerr << modelFile << ": expected a model over (RSS, PDR)"
+                << (model.kind == "forest" ? " with one value per class" : "")
+                << std::endl;
+      return 1;
+    }
+
+  std::ofstream file (output.c_str ());
+  std::string source = modelFile.substr (modelFile.find_last_of ('/') + 1);
+  Generate (file, model, name, source, layout == "select");
+  file.close ();
+  if (file.fail ())
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+  return 0;
+}
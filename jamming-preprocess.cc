@@ -0,0 +1,287 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Turns jamming traces into a training set, replacing the per-class
+ * preprocessing cells of classification.ipynb.
+ *
+ * Usage:
+ *   jamming-preprocess --data-dir=data/powerXdistance --output=features.txt
+ *   jamming-preprocess --trace=sweep.jtr --output=features.txt
+ *   jamming-preprocess --store=datastore --sweep=power --output=features.txt
+ *   jamming-preprocess --series-dir=series/power --output=features.txt
+ *
+ * Options:
+ *   --data-dir=DIR        directory holding rss_<type>_node<N>.txt and
+ *                         pdr_<type>_node<N>.txt files
+ *   --node=N              node number in the file names (default 2)
+ *   --trace=FILE          read a JammingTraceFile instead of text files
+ *   --store=DIR           read the text files of --sweep from a
+ *                         JammingChunkStore (see jamming-store)
+ *   --sweep=NAME          sweep to read from the store, eg. "power"
+ *   --series-dir=DIR      directory holding <type>_node<N>.jsr
+ *                         JammingSeriesFiles (see jamming-series)
+ *   --output=FILE         output file, "rss pdr label" per line
+ *   --rss-floor=DBM       drop samples below this RSS (default -93.5)
+ *   --scaling=MODE        "class" scales each class on its own, as the
+ *                         notebook does (default), "global" fits one scaler
+ *                         to all classes, "none" keeps dBm / PDR values
+ *   --max-per-class=N     keep at most N samples per class (default 4400,
+ *                         0 keeps all)
+ *   --seed=N              shuffle seed (default 1)
+ */
+
+#include "jamming-dataset.h"
+#include "jamming-tool-options.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <algorithm>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program
+            << " (--data-dir=DIR | --trace=FILE | --series-dir=DIR"
+            << " | --store=DIR --sweep=NAME)"
+            << " --output=FILE [--node=N] [--rss-floor=DBM]"
+            << " [--scaling=class|global|none] [--max-per-class=N]"
+            << " [--seed=N]" << std::endl;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string dataDir, trace, seriesDir, store, sweep, output;
+  std::string scaling = "class";
+  std::string node = "2";
+  double rssFloor = JammingFeatureFilter::DEFAULT_RSS_FLOOR;
+  uint32_t maxPerClass = 4400;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if (ParseOption (argv[i], "data-dir", dataDir) ||
+          ParseOption (argv[i], "trace", trace) ||
+          ParseOption (argv[i], "series-dir", seriesDir) ||
+          ParseOption (argv[i], "store", store) ||
+          ParseOption (argv[i], "sweep", sweep) ||
+          ParseOption (argv[i], "output", output) ||
+          ParseOption (argv[i], "node", node) ||
+          ParseOption (argv[i], "scaling", scaling))
+        {
+          continue;
+        }
+      if (ParseOption (argv[i], "rss-floor", value))
+        {
+          rssFloor = std::atof (value.c_str ());
+        }
+      else if (ParseOption (argv[i], "max-per-class", value))
+        {
+          maxPerClass = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "seed", value))
+        {
+          seed = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  int sources = !dataDir.empty () + !trace.empty () + !seriesDir.empty () +
+    !store.empty ();
+  if (output.empty () || sources != 1 || store.empty () != sweep.empty () ||
+      (scaling != "class" && scaling != "global" && scaling != "none"))
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  std::vector<JammingFeatureFilter> filters (JAMMER_TYPE_COUNT,
+                                             JammingFeatureFilter (rssFloor));
+  if (!trace.empty ())
+    {
+      if (!ReadTrace (trace, filters))
+        {
+          std::cerr << "Cannot read trace " << trace << std::endl;
+          return 1;
+        }
+    }
+  else if (!seriesDir.empty ())
+    {
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          std::string seriesFile = seriesDir + "/"
+            + JammerTypeToString (JammerType (t)) + "_node" + node + ".jsr";
+          if (!ReadSeries (seriesFile, filters[t]))
+            {
+              std::cerr << "Cannot read " << seriesFile << std::endl;
+              return 1;
+            }
+        }
+    }
+  else if (!store.empty ())
+    {
+      JammingChunkStore chunks;
+      if (!chunks.Open (store))
+        {
+          std::cerr << "Cannot open store " << store << std::endl;
+          return 1;
+        }
+      uint32_t nodeId = std::strtoul (node.c_str (), NULL, 10);
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          std::string jammer = JammerTypeToString (JammerType (t));
+          JammingChunkKey rssKey (sweep, jammer, nodeId, "rss");
+          JammingChunkKey pdrKey (sweep, jammer, nodeId, "pdr");
+          const std::vector<std::string> *rssChunks = chunks.GetChunks (rssKey);
+          const std::vector<std::string> *pdrChunks = chunks.GetChunks (pdrKey);
+          // same content as an earlier class: reuse its filtered features
+          uint32_t u = 0;
+          for (; rssChunks != NULL && pdrChunks != NULL && u < t; u++)
+            {
+              std::string other = JammerTypeToString (JammerType (u));
+              const std::vector<std::string> *otherRss =
+                chunks.GetChunks (JammingChunkKey (sweep, other, nodeId, "rss"));
+              const std::vector<std::string> *otherPdr =
+                chunks.GetChunks (JammingChunkKey (sweep, other, nodeId, "pdr"));
+              if (otherRss != NULL && otherPdr != NULL &&
+                  *otherRss == *rssChunks && *otherPdr == *pdrChunks)
+                {
+                  break;
+                }
+            }
+          if (u < t)
+            {
+              filters[t] = filters[u];
+              continue;
+            }
+          if (!ReadStoredPair (chunks, rssKey, pdrKey, filters[t]))
+            {
+              std::cerr << "Cannot read " << sweep << " rss / pdr of " << jammer
+                        << " from " << store << std::endl;
+              return 1;
+            }
+        }
+    }
+  else
+    {
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          std::string suffix = std::string (JammerTypeToString (JammerType (t)))
+            + "_node" + node + ".txt";
+          std::string rssFile = dataDir + "/rss_" + suffix;
+          std::string pdrFile = dataDir + "/pdr_" + suffix;
+          if (!ReadTextPair (rssFile, pdrFile, filters[t]))
+            {
+              std::cerr << "Cannot read " << rssFile << " / " << pdrFile
+                        << std::endl;
+              return 1;
+            }
+        }
+    }
+
+  std::mt19937_64 rng (seed);
+  JammingFeatureScaler globalScaler;
+  if (scaling == "global")
+    {
+      std::vector<JammingFeature> all;
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          const std::vector<JammingFeature> &features = filters[t].GetFeatures ();
+          all.insert (all.end (), features.begin (), features.end ());
+        }
+      globalScaler.Fit (all);
+    }
+
+  std::ostringstream header;
+  std::vector<JammingSample> samples;
+  for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+    {
+      std::vector<JammingFeature> features = filters[t].GetFeatures ();
+      // the notebook shuffles before cutting each class to 4400 samples
+      std::shuffle (features.begin (), features.end (), rng);
+      if (maxPerClass > 0 && features.size () > maxPerClass)
+        {
+          features.resize (maxPerClass);
+        }
+      bool empty = filters[t].GetFeatures ().empty ();
+      if (empty)
+        {
+          // labels are no longer 0 .. n-1, which the model export rejects
+          std::cerr << "Warning: no " << JammerTypeToString (JammerType (t))
+                    << " samples left at or above " << rssFloor << " dBm"
+                    << std::endl;
+        }
+      JammingFeatureScaler scaler = globalScaler;
+      if (scaling == "class" && !empty)
+        {
+          // fitted on the whole class, before the cut, like the notebook
+          scaler.Fit (filters[t].GetFeatures ());
+        }
+      if (scaling != "none")
+        {
+          scaler.Transform (features);
+        }
+      header << "# " << JammerTypeToString (JammerType (t)) << ": "
+             << filters[t].GetInputCount () << " raw, "
+             << filters[t].GetFeatures ().size () << " unique, "
+             << features.size () << " kept";
+      if (scaling != "none" && !empty)
+        {
+          header << ", rss [" << scaler.GetRssMin () << ", "
+                 << scaler.GetRssMax () << "] dBm, pdr ["
+                 << scaler.GetPdrMin () << ", " << scaler.GetPdrMax () << "]";
+        }
+      header << "\n";
+      for (uint32_t i = 0; i < features.size (); i++)
+        {
+          JammingSample sample;
+          sample.feature = features[i];
+          sample.label = t;
+          samples.push_back (sample);
+        }
+    }
+  std::shuffle (samples.begin (), samples.end (), rng);
+
+  std::ofstream file (output.c_str ());
+  if (!file.is_open ())
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+  file << "# rss pdr label, scaling = " << scaling << "\n" << header.str ();
+  WriteSamples (file, samples);
+  file.close ();
+  if (file.fail ())
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+  std::cerr << header.str ();
+  return 0;
+}
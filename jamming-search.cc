@@ -0,0 +1,564 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Scores grids of classifier hyperparameters on a held-out feature file,
+ * on all cores, and prints the accuracy and confusion matrix of every
+ * setting.
+ *
+ * Usage:
+ *   jamming-search --train=train.txt --test=test.txt --knn=1:100:1 \
+ *     --forest-trees=10,50,100 --forest-depth=0,10 \
+ *     --boost-stages=1:10:1 --boost-depth=3,10 --boost-rate=0.1,0.4
+ *
+ * Options:
+ *   --train=FILE          "rss pdr label" training samples, scaled
+ *   --test=FILE           samples the settings are scored on
+ *   --knn=LIST            k nearest neighbors, neighbor counts
+ *   --forest-trees=LIST   random forest, tree counts
+ *   --forest-depth=LIST   random forest, max depths (0: no limit; default 0)
+ *   --boost-stages=LIST   gradient boosting, stage counts
+ *   --boost-depth=LIST    gradient boosting, max depths (default 3)
+ *   --boost-rate=LIST     gradient boosting, learning rates (default 0.1)
+ *   --seed=N              seed of the forest draws (default 1)
+ *   --workers=N           threads (default: number of cores)
+ *
+ * LIST is "a,b,c" or "start:stop:step". Candidates share their work
+ * instead of being trained one by one:
+ *
+ * - one neighbor search for the largest k gives every smaller k, as the
+ *   nearest k are a prefix of the nearest k_max; only where samples tie at
+ *   the k-th distance does a search for k itself pick which of them count,
+ *   as sklearn's kd-tree does;
+ * - the feature columns are sorted once, for every forest and boosting
+ *   model;
+ * - one forest per depth is grown with the largest tree count, and a
+ *   forest of T trees is its first T trees (the trees are keyed by index);
+ * - one boosting model per depth and rate is trained with the most stages,
+ *   and the fewer-stage settings are read from its staged scores.
+ *
+ * Output, one line per setting, in grid order:
+ *   <model> <parameters> accuracy <a> confusion <row 0> | <row 1> | ...
+ * with rows for the true labels and columns for the predicted ones.
+ */
+
+#include "gradient-boosting-trainer.h"
+#include "nearest-neighbors-classifier.h"
+#include "random-forest-trainer.h"
+#include "jamming-tool-options.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace ns3;
+
+namespace {
+
+// test samples per neighbor search job
+const uint32_t KNN_CHUNK = 512;
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --train=FILE --test=FILE"
+            << " [--knn=LIST] [--forest-trees=LIST] [--forest-depth=LIST]"
+            << " [--boost-stages=LIST] [--boost-depth=LIST]"
+            << " [--boost-rate=LIST] [--seed=N] [--workers=N]" << std::endl;
+}
+
+/**
+ * \brief Parses "a,b,c" or "start:stop:step", as jamming-sweep does.
+ *
+ * \returns False if the text is malformed or empty.
+ */
+bool
+ParseList (std::string const &text, std::vector<double> &values)
+{
+  values.clear ();
+  double start, stop, step;
+  char c1, c2;
+  std::istringstream range (text);
+  if (text.find (':') != std::string::npos)
+    {
+      if (!(range >> start >> c1 >> stop >> c2 >> step) || c1 != ':' ||
+          c2 != ':' || step <= 0 || stop < start)
+        {
+          return false;
+        }
+      // count steps up front so rounding cannot add or drop a point
+      uint32_t count = uint32_t ((stop - start) / step + 1e-9) + 1;
+      for (uint32_t i = 0; i < count; i++)
+        {
+          values.push_back (start + i * step);
+        }
+      return true;
+    }
+  std::istringstream list (text);
+  std::string value;
+  while (std::getline (list, value, ','))
+    {
+      char *end;
+      double number = std::strtod (value.c_str (), &end);
+      if (value.empty () || *end != '\0')
+        {
+          return false;
+        }
+      values.push_back (number);
+    }
+  return !values.empty ();
+}
+
+/**
+ * \brief Parses a list of counts, sorted and without duplicates.
+ *
+ * \param zero True if 0 is allowed.
+ */
+bool
+ParseCounts (std::string const &text, std::vector<uint32_t> &counts,
+             bool zero)
+{
+  std::vector<double> values;
+  if (!ParseList (text, values))
+    {
+      return false;
+    }
+  counts.clear ();
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      uint32_t count = uint32_t (values[i] + 0.5);
+      if (values[i] < 0 || (count == 0 && !zero))
+        {
+          return false;
+        }
+      counts.push_back (count);
+    }
+  std::sort (counts.begin (), counts.end ());
+  counts.erase (std::unique (counts.begin (), counts.end ()), counts.end ());
+  return true;
+}
+
+/**
+ * Predictions of one setting on the test samples.
+ */
+struct Setting
+{
+  std::string name;
+  std::vector<uint8_t> labels;
+};
+
+/**
+ * \brief Runs jobs on a pool of threads, each taking the next job.
+ */
+void
+RunJobs (std::vector<std::function<void ()> > const &jobs, uint32_t workers)
+{
+  std::atomic<uint32_t> next (0);
+  std::vector<std::thread> threads;
+  for (uint32_t w = 0; w < workers; w++)
+    {
+      threads.push_back (std::thread ([&] ()
+        {
+          for (uint32_t job = next++; job < jobs.size (); job = next++)
+            {
+              jobs[job] ();
+            }
+        }));
+    }
+  for (uint32_t w = 0; w < workers; w++)
+    {
+      threads[w].join ();
+    }
+}
+
+/**
+ * \returns Leaf reached by a feature, comparing as floats like sklearn.
+ */
+int32_t
+FindLeaf (const DecisionTree &tree, const JammingFeature &feature)
+{
+  const float x[2] = { static_cast<float> (feature.rss),
+                       static_cast<float> (feature.pdr) };
+  int32_t node = 0;
+  while (tree.nodes[node].feature >= 0)
+    {
+      const TreeNode &n = tree.nodes[node];
+      node = x[n.feature] <= n.threshold ? n.left : n.right;
+    }
+  return node;
+}
+
+/**
+ * \returns Index of the highest score, the lowest index on a tie.
+ */
+uint8_t
+Argmax (const double *scores, uint32_t n)
+{
+  uint8_t best = 0;
+  for (uint32_t k = 1; k < n; k++)
+    {
+      if (scores[k] > scores[best])
+        {
+          best = k;
+        }
+    }
+  return best;
+}
+
+/**
+ * \brief Scores forest prefixes on the test samples, as
+ * RandomForestClassifier would: mean of the normalized leaf values.
+ *
+ * \param counts Tree counts, ascending.
+ * \param settings One setting per count, labels filled here.
+ */
+void
+ScoreForest (const TreeEnsembleModel &model,
+             std::vector<JammingFeature> const &features,
+             std::vector<uint32_t> const &counts, Setting *settings)
+{
+  uint32_t classes = model.classes;
+  std::vector<double> sum (classes);
+  std::vector<double> mean (classes);
+  for (uint32_t i = 0; i < features.size (); i++)
+    {
+      std::fill (sum.begin (), sum.end (), 0.0);
+      uint32_t next = 0;
+      for (uint32_t t = 0; t < counts.back (); t++)
+        {
+          const DecisionTree &tree = model.trees[t];
+          const double *value = &tree.values[FindLeaf (tree, features[i]) *
+                                             model.outputs];
+          double total = 0.0;
+          for (uint32_t c = 0; c < classes; c++)
+            {
+              total += value[c];
+            }
+          total = total == 0.0 ? 1.0 : total;
+          for (uint32_t c = 0; c < classes; c++)
+            {
+              sum[c] += value[c] / total;
+            }
+          while (next < counts.size () && counts[next] == t + 1)
+            {
+              for (uint32_t c = 0; c < classes; c++)
+                {
+                  mean[c] = sum[c] / (t + 1);
+                }
+              settings[next++].labels[i] = Argmax (&mean[0], classes);
+            }
+        }
+    }
+}
+
+/**
+ * \brief Scores boosting stage prefixes on the test samples, as
+ * TreeEnsembleModel::Predict would.
+ *
+ * \param counts Stage counts, ascending.
+ * \param settings One setting per count, labels filled here.
+ */
+void
+ScoreBoosting (const TreeEnsembleModel &model,
+               std::vector<JammingFeature> const &features,
+               std::vector<uint32_t> const &counts, Setting *settings)
+{
+  uint32_t scores = model.GetScoreCount ();
+  std::vector<double> score (scores);
+  for (uint32_t i = 0; i < features.size (); i++)
+    {
+      std::copy (model.init.begin (), model.init.end (), score.begin ());
+      uint32_t next = 0;
+      for (uint32_t stage = 0; stage < counts.back (); stage++)
+        {
+          for (uint32_t k = 0; k < scores; k++)
+            {
+              const DecisionTree &tree = model.trees[stage * scores + k];
+              score[k] += tree.values[FindLeaf (tree, features[i])];
+            }
+          while (next < counts.size () && counts[next] == stage + 1)
+            {
+              settings[next++].labels[i] = scores == 1 ? score[0] > 0.0
+                : Argmax (&score[0], scores);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string trainFile, testFile;
+  std::string knnList, forestTreeList, forestDepthList = "0";
+  std::string boostStageList, boostDepthList = "3", boostRateList = "0.1";
+  uint32_t seed = 1;
+  uint32_t workers = std::max (1u, std::thread::hardware_concurrency ());
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if (ParseOption (argv[i], "train", trainFile) ||
+          ParseOption (argv[i], "test", testFile) ||
+          ParseOption (argv[i], "knn", knnList) ||
+          ParseOption (argv[i], "forest-trees", forestTreeList) ||
+          ParseOption (argv[i], "forest-depth", forestDepthList) ||
+          ParseOption (argv[i], "boost-stages", boostStageList) ||
+          ParseOption (argv[i], "boost-depth", boostDepthList) ||
+          ParseOption (argv[i], "boost-rate", boostRateList))
+        {
+          continue;
+        }
+      if (ParseOption (argv[i], "seed", value))
+        {
+          seed = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "workers", value))
+        {
+          workers = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+
+  std::vector<uint32_t> ks, forestTrees, forestDepths, boostStages,
+                        boostDepths;
+  std::vector<double> boostRates;
+  if (trainFile.empty () || testFile.empty () || workers == 0 ||
+      (knnList.empty () && forestTreeList.empty () &&
+       boostStageList.empty ()) ||
+      (!knnList.empty () && !ParseCounts (knnList, ks, false)) ||
+      (!forestTreeList.empty () &&
+       (!ParseCounts (forestTreeList, forestTrees, false) ||
+        !ParseCounts (forestDepthList, forestDepths, true))) ||
+      (!boostStageList.empty () &&
+       (!ParseCounts (boostStageList, boostStages, false) ||
+        !ParseCounts (boostDepthList, boostDepths, false) ||
+        !ParseList (boostRateList, boostRates))))
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  std::vector<JammingSample> train, test;
+  if (!ReadSamples (trainFile, train) || train.empty ())
+    {
+      std::cerr << "Cannot read samples from " << trainFile << std::endl;
+      return 1;
+    }
+  if (!ReadSamples (testFile, test) || test.empty ())
+    {
+      std::cerr << "Cannot read samples from " << testFile << std::endl;
+      return 1;
+    }
+  std::vector<JammingFeature> features (test.size ());
+  for (uint32_t i = 0; i < test.size (); i++)
+    {
+      features[i] = test[i].feature;
+    }
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now ();
+  std::vector<Setting> settings;
+  std::vector<std::function<void ()> > jobs;
+
+  // k nearest neighbors: one search for the largest k, per chunk of samples
+  uint32_t knnFirst = settings.size ();
+  Ptr<NearestNeighborsClassifier> knn;
+  if (!ks.empty ())
+    {
+      knn = Create<NearestNeighborsClassifier> (train, ks.back ());
+      for (uint32_t k = 0; k < ks.size (); k++)
+        {
+          std::ostringstream name;
+          name << "knn k=" << ks[k];
+          settings.push_back (Setting ());
+          settings.back ().name = name.str ();
+        }
+    }
+  for (uint32_t begin = 0; knn != NULL && begin < test.size ();
+       begin += KNN_CHUNK)
+    {
+      jobs.push_back ([&, begin] ()
+        {
+          std::vector<NearestNeighborsClassifier::Neighbor> neighbors;
+          std::vector<NearestNeighborsClassifier::Neighbor> tied;
+          uint32_t end = std::min<uint32_t> (begin + KNN_CHUNK, test.size ());
+          for (uint32_t i = begin; i < end; i++)
+            {
+              knn->FindNeighbors (features[i], ks.back (), neighbors);
+              double votes[JAMMER_TYPE_COUNT] = { 0.0 };
+              uint32_t next = 0;
+              for (uint32_t j = 0; j < neighbors.size (); j++)
+                {
+                  votes[knn->GetLabel (neighbors[j].index)] += 1.0;
+                  for (; next < ks.size () && ks[next] == j + 1; next++)
+                    {
+                      uint8_t &label = settings[knnFirst + next].labels[i];
+                      label = Argmax (votes, JAMMER_TYPE_COUNT);
+                      if (j + 1 == neighbors.size () ||
+                          neighbors[j + 1].distance != neighbors[j].distance)
+                        {
+                          continue;
+                        }
+                      // tie across the k-th distance
+                      knn->FindNeighbors (features[i], ks[next], tied);
+                      double tiedVotes[JAMMER_TYPE_COUNT] = { 0.0 };
+                      for (uint32_t t = 0; t < tied.size (); t++)
+                        {
+                          tiedVotes[knn->GetLabel (tied[t].index)] += 1.0;
+                        }
+                      label = Argmax (tiedVotes, JAMMER_TYPE_COUNT);
+                    }
+                }
+              // k beyond the training set: every sample votes
+              for (; next < ks.size (); next++)
+                {
+                  settings[knnFirst + next].labels[i] =
+                    Argmax (votes, JAMMER_TYPE_COUNT);
+                }
+            }
+        });
+    }
+
+  // tree models share one sorting of the training columns
+  Ptr<TrainingColumns> columns;
+  if (!forestTrees.empty () || !boostStages.empty ())
+    {
+      columns = Create<TrainingColumns> (train);
+    }
+
+  // random forests: one forest per depth, its tree prefixes
+  uint32_t forestFirst = settings.size ();
+  std::vector<RandomForestTrainer> forestTrainers (forestDepths.size ());
+  std::vector<TreeEnsembleModel> forests (forestDepths.size ());
+  for (uint32_t d = 0; d < forestDepths.size (); d++)
+    {
+      for (uint32_t t = 0; t < forestTrees.size (); t++)
+        {
+          std::ostringstream name;
+          name << "forest trees=" << forestTrees[t] << " max_depth="
+               << forestDepths[d];
+          settings.push_back (Setting ());
+          settings.back ().name = name.str ();
+        }
+      RandomForestTrainer &trainer = forestTrainers[d];
+      trainer.SetColumns (columns);
+      trainer.SetTreeCount (forestTrees.back ());
+      trainer.SetMaxDepth (forestDepths[d]);
+      trainer.SetSeed (seed);
+      trainer.InitModel (forests[d]);
+      for (uint32_t t = 0; t < forestTrees.back (); t++)
+        {
+          jobs.push_back ([&, d, t] ()
+            {
+              forestTrainers[d].TrainTree (t, forests[d].trees[t]);
+            });
+        }
+    }
+
+  /*
+   * Gradient boosting: one model per depth and rate, its stage prefixes.
+   * Trainers are set up here, as are the forest trainers: copying the
+   * columns pointer from the workers would race on its reference count.
+   */
+  uint32_t boostFirst = settings.size ();
+  std::vector<GradientBoostingTrainer> boostTrainers (boostDepths.size () *
+                                                      boostRates.size ());
+  for (uint32_t d = 0; d < boostDepths.size (); d++)
+    {
+      for (uint32_t r = 0; r < boostRates.size (); r++)
+        {
+          uint32_t first = settings.size ();
+          for (uint32_t s = 0; s < boostStages.size (); s++)
+            {
+              std::ostringstream name;
+              name << "boosting stages=" << boostStages[s] << " max_depth="
+                   << boostDepths[d] << " learning_rate=" << boostRates[r];
+              settings.push_back (Setting ());
+              settings.back ().name = name.str ();
+            }
+          uint32_t b = d * boostRates.size () + r;
+          boostTrainers[b].SetColumns (columns);
+          boostTrainers[b].SetStageCount (boostStages.back ());
+          boostTrainers[b].SetMaxDepth (boostDepths[d]);
+          boostTrainers[b].SetLearningRate (boostRates[r]);
+          jobs.push_back ([&, b, first] ()
+            {
+              TreeEnsembleModel model;
+              boostTrainers[b].Train (model);
+              ScoreBoosting (model, features, boostStages, &settings[first]);
+            });
+        }
+    }
+
+  for (uint32_t s = 0; s < settings.size (); s++)
+    {
+      settings[s].labels.resize (test.size ());
+    }
+  RunJobs (jobs, workers);
+
+  // forests are scored once all their trees are grown
+  jobs.clear ();
+  for (uint32_t d = 0; d < forestDepths.size (); d++)
+    {
+      jobs.push_back ([&, d] ()
+        {
+          ScoreForest (forests[d], features, forestTrees,
+                       &settings[forestFirst + d * forestTrees.size ()]);
+        });
+    }
+  RunJobs (jobs, workers);
+  double seconds = std::chrono::duration<double> (
+      std::chrono::steady_clock::now () - start).count ();
+
+  for (uint32_t s = 0; s < settings.size (); s++)
+    {
+      uint32_t confusion[JAMMER_TYPE_COUNT][JAMMER_TYPE_COUNT] = { { 0 } };
+      uint32_t correct = 0;
+      for (uint32_t i = 0; i < test.size (); i++)
+        {
+          confusion[test[i].label][settings[s].labels[i]]++;
+          correct += test[i].label == settings[s].labels[i];
+        }
+      std::cout << settings[s].name << " accuracy "
+                << double (correct) / test.size () << " confusion";
+      for (uint32_t t = 0; t < JAMMER_TYPE_COUNT; t++)
+        {
+          std::cout << (t > 0 ? " |" : "");
+          for (uint32_t p = 0; p < JAMMER_TYPE_COUNT; p++)
+            {
+              std::cout << " " << confusion[t][p];
+            }
+        }
+      std::cout << "\n";
+    }
+  std::cerr << "Scored " << settings.size () << " settings ("
+            << boostFirst - forestFirst << " forest, "
+            << settings.size () - boostFirst << " boosting, "
+            << forestFirst - knnFirst << " knn) in " << seconds * 1e3
+            << " ms on " << workers << " workers" << std::endl;
+  return 0;
+}
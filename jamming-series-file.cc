@@ -0,0 +1,552 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-series-file.h"
+#include <cstring>
+
+namespace ns3 {
+
+namespace {
+
+const uint32_t RSS_LAG_BITS = 3;      // RSS repeats within 8 values
+const uint32_t PDR_LAG_BITS = 6;      // PDR run values repeat within 64 runs
+
+inline uint32_t
+LeadingZeros (uint64_t x)
+{
+  return __builtin_clzll (x);
+}
+
+inline uint32_t
+TrailingZeros (uint64_t x)
+{
+  return __builtin_ctzll (x);
+}
+
+inline uint64_t
+DoubleBits (double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  return bits;
+}
+
+inline double
+BitsDouble (uint64_t bits)
+{
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+/**
+ * Appends bits MSB first to a byte vector.
+ */
+class BitWriter
+{
+public:
+  BitWriter (std::vector<uint8_t> &bytes)
+    : m_bytes (bytes),
+      m_acc (0),
+      m_count (0)
+  {
+  }
+
+  void Write (uint64_t value, uint32_t bits)
+  {
+    while (bits > 0)
+      {
+        uint32_t n = bits < 8 - m_count ? bits : 8 - m_count;
+        bits -= n;
+        m_acc = (m_acc << n) | ((value >> bits) & ((1u << n) - 1));
+        m_count += n;
+        if (m_count == 8)
+          {
+            m_bytes.push_back (m_acc);
+            m_acc = 0;
+            m_count = 0;
+          }
+      }
+  }
+
+  /**
+   * Elias gamma code of value >= 1.
+   */
+  void WriteGamma (uint64_t value)
+  {
+    uint32_t bits = 64 - LeadingZeros (value);
+    Write (0, bits - 1);
+    Write (value, bits);
+  }
+
+  void Finish (void)
+  {
+    if (m_count > 0)
+      {
+        m_bytes.push_back (m_acc << (8 - m_count));
+        m_acc = 0;
+        m_count = 0;
+      }
+  }
+
+private:
+  std::vector<uint8_t> &m_bytes;
+  uint32_t m_acc;
+  uint32_t m_count;
+};
+
+/**
+ * Reads bits MSB first. Reading past the end yields zero bits and sets the
+ * overrun flag.
+ */
+class BitReader
+{
+public:
+  BitReader (const uint8_t *data, uint32_t size)
+    : m_data (data),
+      m_size (size),
+      m_pos (0),
+      m_acc (0),
+      m_count (0),
+      m_overrun (false)
+  {
+  }
+
+  uint64_t Read (uint32_t bits)
+  {
+    uint64_t value = 0;
+    while (bits > 0)
+      {
+        if (m_count == 0)
+          {
+            if (m_pos == m_size)
+              {
+                m_overrun = true;
+                return value << bits;
+              }
+            m_acc = m_data[m_pos++];
+            m_count = 8;
+          }
+        uint32_t n = bits < m_count ? bits : m_count;
+        m_count -= n;
+        bits -= n;
+        value = (value << n) | ((m_acc >> m_count) & ((1u << n) - 1));
+      }
+    return value;
+  }
+
+  uint64_t ReadGamma (void)
+  {
+    uint32_t zeros = 0;
+    while (Read (1) == 0)
+      {
+        if (m_overrun || ++zeros == 64)
+          {
+            m_overrun = true;
+            return 1;
+          }
+      }
+    return (uint64_t (1) << zeros) | Read (zeros);
+  }
+
+  bool Overrun (void) const
+  {
+    return m_overrun;
+  }
+
+private:
+  const uint8_t *m_data;
+  uint32_t m_size;
+  uint32_t m_pos;
+  uint32_t m_acc;
+  uint32_t m_count;
+  bool m_overrun;
+};
+
+/**
+ * XOR-of-previous value coder that first tries to repeat an earlier value
+ * of the series. The encoder and decoder keep the same state.
+ */
+class ValueCoder
+{
+public:
+  /**
+   * \param lagBits Number of bits of a lag, the coder looks back up to
+   * 2^lagBits values.
+   */
+  ValueCoder (uint32_t lagBits)
+    : m_lagBits (lagBits),
+      m_history (uint32_t (1) << lagBits, 0),
+      m_count (0),
+      m_lag (1),
+      m_leading (64),
+      m_trailing (0)
+  {
+  }
+
+  void Encode (BitWriter &writer, double value)
+  {
+    uint64_t bits = DoubleBits (value);
+    if (m_count == 0)
+      {
+        writer.Write (bits, 64);
+        Push (bits);
+        return;
+      }
+    if (bits == Back (m_lag))
+      {
+        writer.Write (0, 1);
+        Push (bits);
+        return;
+      }
+    uint32_t depth = m_count < m_history.size () ? m_count : m_history.size ();
+    for (uint32_t lag = 1; lag <= depth; lag++)
+      {
+        if (Back (lag) == bits)
+          {
+            writer.Write (2, 2);
+            writer.Write (lag - 1, m_lagBits);
+            m_lag = lag;
+            Push (bits);
+            return;
+          }
+      }
+    uint64_t x = bits ^ Back (1);
+    uint32_t leading = LeadingZeros (x);
+    uint32_t trailing = TrailingZeros (x);
+    if (leading >= m_leading && trailing >= m_trailing)
+      {
+        writer.Write (6, 3);
+        writer.Write (x >> m_trailing, 64 - m_leading - m_trailing);
+      }
+    else
+      {
+        uint32_t length = 64 - leading - trailing;
+        writer.Write (7, 3);
+        writer.Write (leading, 6);
+        writer.Write (length - 1, 6);
+        writer.Write (x >> trailing, length);
+        m_leading = leading;
+        m_trailing = trailing;
+      }
+    Push (bits);
+  }
+
+  double Decode (BitReader &reader)
+  {
+    uint64_t bits;
+    if (m_count == 0)
+      {
+        bits = reader.Read (64);
+      }
+    else if (reader.Read (1) == 0)
+      {
+        bits = Back (m_lag);
+      }
+    else if (reader.Read (1) == 0)
+      {
+        m_lag = reader.Read (m_lagBits) + 1;
+        bits = Back (m_lag);
+      }
+    else
+      {
+        uint64_t x;
+        if (reader.Read (1) == 0)
+          {
+            x = reader.Read (64 - m_leading - m_trailing) << m_trailing;
+          }
+        else
+          {
+            m_leading = reader.Read (6);
+            uint32_t length = reader.Read (6) + 1;
+            m_trailing = 64 - m_leading - length;
+            if (m_leading + length > 64)
+              {
+                m_leading = 64 - length; // damaged stream, keep shifts defined
+                m_trailing = 0;
+              }
+            x = reader.Read (length) << m_trailing;
+          }
+        bits = Back (1) ^ x;
+      }
+    Push (bits);
+    return BitsDouble (bits);
+  }
+
+private:
+  /**
+   * \returns Value lag places back, 1 being the previous value. Slots not
+   * written yet read as 0.
+   */
+  uint64_t Back (uint32_t lag) const
+  {
+    return m_history[(m_count - lag) & (m_history.size () - 1)];
+  }
+
+  void Push (uint64_t bits)
+  {
+    m_history[m_count & (m_history.size () - 1)] = bits;
+    m_count++;
+  }
+
+  uint32_t m_lagBits;
+  std::vector<uint64_t> m_history;  // ring of the last values
+  uint32_t m_count;                 // values coded so far
+  uint32_t m_lag;                   // lag of the last repeat, tried first
+  uint32_t m_leading;               // zero window of the last explicit XOR
+  uint32_t m_trailing;
+};
+
+} // anonymous namespace
+
+const uint32_t JammingSeriesFile::MAGIC;
+const uint16_t JammingSeriesFile::VERSION;
+const uint32_t JammingSeriesFile::HEADER_SIZE;
+const uint32_t JammingSeriesFile::BLOCK_HEADER_SIZE;
+const uint32_t JammingSeriesFile::DEFAULT_BLOCK_ROWS;
+
+JammingSeriesFile::JammingSeriesFile ()
+  : m_mode (std::ios::in),
+    m_fail (false),
+    m_blockRows (DEFAULT_BLOCK_ROWS),
+    m_rows (0),
+    m_cursor (0)
+{
+}
+
+JammingSeriesFile::~JammingSeriesFile ()
+{
+  Close ();
+}
+
+void
+JammingSeriesFile::Open (std::string const &filename, std::ios::openmode mode,
+                         uint32_t blockRows)
+{
+  Close ();
+  m_fail = false;
+  m_rows = 0;
+  m_cursor = 0;
+  m_mode = (mode & std::ios::out) ? std::ios::out : std::ios::in;
+
+  m_file.open (filename.c_str (), m_mode | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      m_fail = true;
+      return;
+    }
+
+  uint8_t header[HEADER_SIZE];
+  std::memset (header, 0, HEADER_SIZE);
+  if (m_mode == std::ios::out)
+    {
+      m_blockRows = blockRows > 0 ? blockRows : DEFAULT_BLOCK_ROWS;
+      uint32_t magic = MAGIC;
+      uint16_t version = VERSION;
+      std::memcpy (header, &magic, 4);
+      std::memcpy (header + 4, &version, 2);
+      std::memcpy (header + 8, &m_blockRows, 4);
+      m_file.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+      m_fail = m_file.fail ();
+      m_rss.resize (m_blockRows);
+      m_pdr.resize (m_blockRows);
+      return;
+    }
+
+  m_file.read (reinterpret_cast<char *> (header), HEADER_SIZE);
+  uint32_t magic;
+  uint16_t version;
+  std::memcpy (&magic, header, 4);
+  std::memcpy (&version, header + 4, 2);
+  std::memcpy (&m_blockRows, header + 8, 4);
+  if (m_file.fail () || magic != MAGIC || version != VERSION ||
+      m_blockRows == 0)
+    {
+      m_fail = true;
+    }
+}
+
+void
+JammingSeriesFile::Close (void)
+{
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  if (m_mode == std::ios::out)
+    {
+      FlushBlock ();
+    }
+  m_file.close ();
+}
+
+bool
+JammingSeriesFile::Fail (void) const
+{
+  return m_fail;
+}
+
+void
+JammingSeriesFile::Write (double rss, double pdr)
+{
+  if (m_fail || m_mode != std::ios::out)
+    {
+      m_fail = true;
+      return;
+    }
+  m_rss[m_rows] = rss;
+  m_pdr[m_rows] = pdr;
+  if (++m_rows == m_blockRows)
+    {
+      FlushBlock ();
+    }
+}
+
+uint32_t
+JammingSeriesFile::Read (double *rss, double *pdr, uint32_t n)
+{
+  if (m_fail || m_mode != std::ios::in)
+    {
+      return 0;
+    }
+  uint32_t count = 0;
+  while (count < n)
+    {
+      if (m_cursor == m_rows && !LoadBlock ())
+        {
+          break;
+        }
+      uint32_t chunk = m_rows - m_cursor;
+      if (chunk > n - count)
+        {
+          chunk = n - count;
+        }
+      std::memcpy (rss + count, &m_rss[m_cursor], chunk * sizeof (double));
+      std::memcpy (pdr + count, &m_pdr[m_cursor], chunk * sizeof (double));
+      m_cursor += chunk;
+      count += chunk;
+    }
+  return count;
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+JammingSeriesFile::FlushBlock (void)
+{
+  if (m_rows == 0)
+    {
+      return;
+    }
+  m_bytes.clear ();
+  BitWriter rssWriter (m_bytes);
+  ValueCoder rssCoder (RSS_LAG_BITS);
+  for (uint32_t i = 0; i < m_rows; i++)
+    {
+      rssCoder.Encode (rssWriter, m_rss[i]);
+    }
+  rssWriter.Finish ();
+  uint32_t rssBytes = m_bytes.size ();
+
+  BitWriter pdrWriter (m_bytes);
+  ValueCoder pdrCoder (PDR_LAG_BITS);
+  for (uint32_t i = 0; i < m_rows;)
+    {
+      uint64_t value = DoubleBits (m_pdr[i]);
+      uint32_t run = 1;
+      while (i + run < m_rows && DoubleBits (m_pdr[i + run]) == value)
+        {
+          run++;
+        }
+      pdrCoder.Encode (pdrWriter, m_pdr[i]);
+      pdrWriter.WriteGamma (run);
+      i += run;
+    }
+  pdrWriter.Finish ();
+  uint32_t pdrBytes = m_bytes.size () - rssBytes;
+
+  uint32_t blockHeader[4] = { m_rows, rssBytes, pdrBytes, 0 };
+  m_file.write (reinterpret_cast<const char *> (blockHeader),
+                BLOCK_HEADER_SIZE);
+  m_file.write (reinterpret_cast<const char *> (&m_bytes[0]), m_bytes.size ());
+  m_fail = m_fail || m_file.fail ();
+  m_rows = 0;
+}
+
+bool
+JammingSeriesFile::LoadBlock (void)
+{
+  uint32_t blockHeader[4];
+  m_file.read (reinterpret_cast<char *> (blockHeader), BLOCK_HEADER_SIZE);
+  if (m_file.gcount () == 0 && m_file.eof ())
+    {
+      return false;
+    }
+  uint32_t rows = blockHeader[0];
+  uint32_t rssBytes = blockHeader[1];
+  uint32_t pdrBytes = blockHeader[2];
+  // a value takes at most 79 bits, a PDR run 79 bits plus a 63 bit length
+  if (m_file.fail () || rows == 0 || rows > m_blockRows ||
+      rssBytes > uint64_t (rows) * 10 + 8 || pdrBytes > uint64_t (rows) * 18 + 8)
+    {
+      m_fail = true;
+      return false;
+    }
+  m_bytes.resize (rssBytes + pdrBytes + 1);
+  m_file.read (reinterpret_cast<char *> (&m_bytes[0]), rssBytes + pdrBytes);
+  if (m_file.fail ())
+    {
+      m_fail = true;
+      return false;
+    }
+
+  m_rss.resize (rows);
+  m_pdr.resize (rows);
+  BitReader rssReader (&m_bytes[0], rssBytes);
+  ValueCoder rssCoder (RSS_LAG_BITS);
+  for (uint32_t i = 0; i < rows; i++)
+    {
+      m_rss[i] = rssCoder.Decode (rssReader);
+    }
+  BitReader pdrReader (&m_bytes[rssBytes], pdrBytes);
+  ValueCoder pdrCoder (PDR_LAG_BITS);
+  for (uint32_t i = 0; i < rows;)
+    {
+      double value = pdrCoder.Decode (pdrReader);
+      uint64_t run = pdrReader.ReadGamma ();
+      if (run > rows - i)
+        {
+          m_fail = true;
+          return false;
+        }
+      for (uint32_t end = i + run; i < end; i++)
+        {
+          m_pdr[i] = value;
+        }
+    }
+  if (rssReader.Overrun () || pdrReader.Overrun ())
+    {
+      m_fail = true;
+      return false;
+    }
+  m_rows = rows;
+  m_cursor = 0;
+  return true;
+}
+
+} // namespace ns3
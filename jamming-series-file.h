@@ -0,0 +1,133 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_SERIES_FILE_H
+#define JAMMING_SERIES_FILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace ns3 {
+
+/**
+ * \brief Compressed (RSS, PDR) series file.
+ *
+ * A compact replacement for the rss_*.txt / pdr_*.txt pairs, for scenarios
+ * that only record the two series. Values are stored losslessly as doubles.
+ *
+ * Both series go through the same value coder: Gorilla style XOR with the
+ * previous value, which first tries to repeat a recent value of the series,
+ * since RSS traces cycle between a few levels. Per value:
+ *   '0'                    same as the value "lag" places back, where lag
+ *                          is the lag of the last repeat (initially 1)
+ *   '10' + lag bits        same as the value lag places back, sets lag
+ *   '110' + bits           XOR with previous fits in the previous
+ *                          leading / trailing zero window
+ *   '111' + 6 bits leading zeros + 6 bits (length - 1) + bits
+ * The first value of a block is stored raw in 64 bits. RSS looks back 8
+ * values.
+ *
+ * PDR is mostly long runs of the same value, so it is run-length coded:
+ * each run is its value, coded as above looking back 64 runs, then its
+ * length in Elias gamma code.
+ *
+ * File layout (native byte order, bit streams MSB first):
+ *
+ *   header (16 bytes):
+ *     uint32 magic ("JSRS"), uint16 version, uint16 reserved,
+ *     uint32 rows per block, uint32 reserved
+ *   blocks, each:
+ *     uint32 number of rows n, uint32 RSS bytes, uint32 PDR bytes,
+ *     uint32 reserved
+ *     RSS bit stream, PDR bit stream
+ *
+ * Every block starts with fresh coder state, so blocks decode on their own.
+ */
+class JammingSeriesFile
+{
+public:
+  static const uint32_t MAGIC = 0x5352534a;       // "JSRS"
+  static const uint16_t VERSION = 1;
+  static const uint32_t HEADER_SIZE = 16;
+  static const uint32_t BLOCK_HEADER_SIZE = 16;
+  static const uint32_t DEFAULT_BLOCK_ROWS = 65536;
+
+  JammingSeriesFile ();
+  ~JammingSeriesFile ();
+
+  /**
+   * \brief Opens a series file.
+   *
+   * \param filename Name of the file.
+   * \param mode std::ios::in to read an existing file, std::ios::out to
+   * create a new one.
+   * \param blockRows Rows per block, only used when writing.
+   *
+   * Check Fail () afterwards.
+   */
+  void Open (std::string const &filename, std::ios::openmode mode,
+             uint32_t blockRows = DEFAULT_BLOCK_ROWS);
+
+  /**
+   * Flushes the pending block (when writing) and closes the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns True if the last operation on the file failed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Appends one (RSS, PDR) pair.
+   *
+   * \param rss RSS, in Watts.
+   * \param pdr PDR.
+   */
+  void Write (double rss, double pdr);
+
+  /**
+   * \brief Decodes the next pairs straight into arrays.
+   *
+   * \param rss Array receiving up to n RSS values.
+   * \param pdr Array receiving up to n PDR values.
+   * \param n Array size.
+   * \returns Number of pairs read, 0 at end of file or on error.
+   */
+  uint32_t Read (double *rss, double *pdr, uint32_t n);
+
+private:
+  void FlushBlock (void);
+  bool LoadBlock (void);
+
+private:
+  std::fstream m_file;
+  std::ios::openmode m_mode;
+  bool m_fail;
+  uint32_t m_blockRows;         // rows per block
+  uint32_t m_rows;              // rows held in the buffers
+  uint32_t m_cursor;            // next row to read from the buffers
+  std::vector<double> m_rss;    // current block, decoded
+  std::vector<double> m_pdr;
+  std::vector<uint8_t> m_bytes; // encoding scratch buffer
+
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_SERIES_FILE_H */
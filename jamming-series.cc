@@ -0,0 +1,166 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Converts rss_*.txt / pdr_*.txt pairs to a compressed JammingSeriesFile
+ * and back.
+ *
+ * Usage:
+ *   jamming-series --rss=rss_constantjammer_node2.txt \
+ *     --pdr=pdr_constantjammer_node2.txt --output=constantjammer_node2.jsr
+ *   jamming-series --input=constantjammer_node2.jsr --rss=rss.txt --pdr=pdr.txt
+ *
+ * Options:
+ *   --rss=FILE      RSS text file, one value in Watts per line
+ *   --pdr=FILE      PDR text file, one value per line
+ *   --output=FILE   series file to write from the text files
+ *   --input=FILE    series file to write back to the text files
+ */
+
+#include "jamming-series-file.h"
+#include "jamming-tool-options.h"
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --rss=FILE --pdr=FILE"
+            << " (--output=FILE | --input=FILE)" << std::endl;
+}
+
+/**
+ * \returns False if the file cannot be read or has a malformed line.
+ */
+bool
+ReadValues (std::string const &filename, std::vector<double> &values)
+{
+  std::FILE *file = std::fopen (filename.c_str (), "r");
+  if (file == NULL)
+    {
+      return false;
+    }
+  double value;
+  int got;
+  while ((got = std::fscanf (file, "%lf", &value)) == 1)
+    {
+      values.push_back (value);
+    }
+  bool ok = got == EOF && !std::ferror (file);
+  std::fclose (file);
+  return ok;
+}
+
+/**
+ * Writes values with %g, the format of the scenario text files.
+ */
+bool
+WriteValues (std::string const &filename, const std::vector<double> &values)
+{
+  std::FILE *file = std::fopen (filename.c_str (), "w");
+  if (file == NULL)
+    {
+      return false;
+    }
+  for (size_t i = 0; i < values.size (); i++)
+    {
+      std::fprintf (file, "%g\n", values[i]);
+    }
+  return std::fclose (file) == 0;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string rssFile, pdrFile, output, input;
+  for (int i = 1; i < argc; i++)
+    {
+      if (!ParseOption (argv[i], "rss", rssFile) &&
+          !ParseOption (argv[i], "pdr", pdrFile) &&
+          !ParseOption (argv[i], "output", output) &&
+          !ParseOption (argv[i], "input", input))
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  if (rssFile.empty () || pdrFile.empty () || output.empty () == input.empty ())
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  std::vector<double> rss, pdr;
+  if (!output.empty ())
+    {
+      if (!ReadValues (rssFile, rss) || !ReadValues (pdrFile, pdr) ||
+          rss.size () != pdr.size ())
+        {
+          std::cerr << "Cannot read " << rssFile << " / " << pdrFile
+                    << " as a pair" << std::endl;
+          return 1;
+        }
+      JammingSeriesFile series;
+      series.Open (output, std::ios::out);
+      for (size_t i = 0; i < rss.size (); i++)
+        {
+          series.Write (rss[i], pdr[i]);
+        }
+      series.Close ();
+      if (series.Fail ())
+        {
+          std::cerr << "Cannot write " << output << std::endl;
+          return 1;
+        }
+      std::cerr << "Wrote " << rss.size () << " pairs to " << output
+                << std::endl;
+      return 0;
+    }
+
+  JammingSeriesFile series;
+  series.Open (input, std::ios::in);
+  const uint32_t chunk = 4096;
+  uint32_t n;
+  do
+    {
+      rss.resize (rss.size () + chunk);
+      pdr.resize (pdr.size () + chunk);
+      n = series.Read (&rss[rss.size () - chunk], &pdr[pdr.size () - chunk],
+                       chunk);
+      rss.resize (rss.size () - chunk + n);
+      pdr.resize (pdr.size () - chunk + n);
+    }
+  while (n > 0);
+  if (series.Fail ())
+    {
+      std::cerr << "Cannot read " << input << std::endl;
+      return 1;
+    }
+  if (!WriteValues (rssFile, rss) || !WriteValues (pdrFile, pdr))
+    {
+      std::cerr << "Cannot write " << rssFile << " / " << pdrFile << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Imports dataset text files into a JammingChunkStore, exports them back, or
+ * lists what is stored.
+ *
+ * Usage:
+ *   jamming-store --store=datastore --sweep=power --import=data/power
+ *   jamming-store --store=datastore --sweep=power --export=restored/power
+ *   jamming-store --store=datastore --list=1
+ *
+ * Options:
+ *   --store=DIR     store directory, created if needed
+ *   --sweep=NAME    sweep the files belong to
+ *   --import=DIR    stores every <stream>_<jammer>_node<N>.txt file of DIR
+ *   --export=DIR    writes the files of the sweep back under their names,
+ *                   creating DIR if needed
+ *   --list=1        prints the manifest entries and their chunk counts
+ */
+
+#include "jamming-chunk-store.h"
+#include "jamming-tool-options.h"
+#include <cerrno>
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --store=DIR"
+            << " (--sweep=NAME (--import=DIR | --export=DIR) | --list=1)"
+            << std::endl;
+}
+
+/**
+ * \brief Splits "rss_constantjammer_node2.txt" into its key.
+ *
+ * \returns False if the name does not follow the dataset layout.
+ */
+bool
+ParseName (std::string const &name, std::string const &sweep,
+           JammingChunkKey &key)
+{
+  size_t stream = name.find ('_');
+  size_t node = name.rfind ("_node");
+  if (stream == std::string::npos || node == std::string::npos ||
+      node <= stream + 1 || name.size () < 4 ||
+      name.compare (name.size () - 4, 4, ".txt") != 0)
+    {
+      return false;
+    }
+  std::string number = name.substr (node + 5, name.size () - 4 - node - 5);
+  char *end;
+  unsigned long value = std::strtoul (number.c_str (), &end, 10);
+  if (number.empty () || *end != '\0')
+    {
+      return false;
+    }
+  key = JammingChunkKey (sweep, name.substr (stream + 1, node - stream - 1),
+                         value, name.substr (0, stream));
+  return true;
+}
+
+/**
+ * \brief Creates a directory and its missing parents, as "mkdir -p".
+ */
+bool
+MakeDirectory (std::string const &path)
+{
+  for (size_t slash = path.find ('/', 1); ; slash = path.find ('/', slash + 1))
+    {
+      std::string prefix = path.substr (0, slash);
+      if (mkdir (prefix.c_str (), 0777) != 0 && errno != EEXIST)
+        {
+          return false;
+        }
+      if (slash == std::string::npos)
+        {
+          return true;
+        }
+    }
+}
+
+std::string
+MakeName (const JammingChunkKey &key)
+{
+  std::ostringstream os;
+  os << key.stream << "_" << key.jammer << "_node" << key.node << ".txt";
+  return os.str ();
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string storeDir, sweep, importDir, exportDir, list;
+  for (int i = 1; i < argc; i++)
+    {
+      if (!ParseOption (argv[i], "store", storeDir) &&
+          !ParseOption (argv[i], "sweep", sweep) &&
+          !ParseOption (argv[i], "import", importDir) &&
+          !ParseOption (argv[i], "export", exportDir) &&
+          !ParseOption (argv[i], "list", list))
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  int actions = !importDir.empty () + !exportDir.empty () + !list.empty ();
+  if (storeDir.empty () || actions != 1 || (list.empty () && sweep.empty ()))
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  JammingChunkStore store;
+  if (!store.Open (storeDir))
+    {
+      std::cerr << "Cannot open store " << storeDir << std::endl;
+      return 1;
+    }
+
+  if (!importDir.empty ())
+    {
+      DIR *dir = opendir (importDir.c_str ());
+      if (dir == NULL)
+        {
+          std::cerr << "Cannot read " << importDir << std::endl;
+          return 1;
+        }
+      uint32_t files = 0;
+      for (struct dirent *entry = readdir (dir); entry != NULL;
+           entry = readdir (dir))
+        {
+          JammingChunkKey key;
+          if (!ParseName (entry->d_name, sweep, key))
+            {
+              continue;
+            }
+          std::string path = importDir + "/" + entry->d_name;
+          if (!store.PutFile (key, path))
+            {
+              std::cerr << "Cannot store " << path << std::endl;
+              closedir (dir);
+              return 1;
+            }
+          files++;
+        }
+      closedir (dir);
+      if (!store.Flush ())
+        {
+          std::cerr << "Cannot write manifest of " << storeDir << std::endl;
+          return 1;
+        }
+      std::cerr << "Stored " << files << " files: "
+                << store.GetNewChunkCount () << " new chunks, "
+                << store.GetDuplicateChunkCount () << " already stored"
+                << std::endl;
+      return 0;
+    }
+
+  std::vector<JammingChunkKey> keys = store.GetKeys ();
+  if (!exportDir.empty ())
+    {
+      if (!MakeDirectory (exportDir))
+        {
+          std::cerr << "Cannot create " << exportDir << std::endl;
+          return 1;
+        }
+      uint32_t files = 0;
+      for (uint32_t i = 0; i < keys.size (); i++)
+        {
+          if (keys[i].sweep != sweep)
+            {
+              continue;
+            }
+          std::string path = exportDir + "/" + MakeName (keys[i]);
+          if (!store.GetFile (keys[i], path))
+            {
+              std::cerr << "Cannot restore " << path << std::endl;
+              return 1;
+            }
+          files++;
+        }
+      std::cerr << "Restored " << files << " files" << std::endl;
+      return 0;
+    }
+
+  for (uint32_t i = 0; i < keys.size (); i++)
+    {
+      std::cout << keys[i].sweep << "/" << MakeName (keys[i]) << " "
+                << store.GetChunks (keys[i])->size () << " chunks"
+                << std::endl;
+    }
+  return 0;
+}
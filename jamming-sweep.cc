@@ -0,0 +1,393 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Runs a jammer TX power x distance sweep as independent simulations on a
+ * pool of worker processes, then merges the per-cell trace shards.
+ *
+ * Each grid cell runs the scenario command once, writing its own
+ * JammingTraceFile shard. Shards are merged in grid order (power major,
+ * distance minor), so the merged trace does not depend on which worker
+ * finished first.
+ *
+ * Usage:
+ *   jamming-sweep --program=./build/jamming-scenario --jammer=constant \
+ *     --power=0.001:0.01:0.001 --distance=5:50:5 --output=constant.jtr
+ *
+ * Options:
+ *   --program=PATH      scenario binary, substituted for {program}
+ *                       (required unless --command does not use it)
+ *   --jammer=TYPE       none, constant, reactive or random
+ *   --power=LIST        TX powers in Watts, "a,b,c" or "start:stop:step"
+ *   --distance=LIST     distances in meters, same syntax
+ *   --command=TEMPLATE  command run for each cell (default
+ *                       "{program} --jammer={jammer} --txPower={power}
+ *                       --distance={distance} --trace={trace}"); also knows
+ *                       {cell}, the index of the cell in the grid
+ *   --workers=N         concurrent simulations (default: number of cores)
+ *   --shard-dir=DIR     where shards are written (default "sweep-shards")
+ *   --output=FILE       merged trace
+ *   --keep-shards=1     keep shards after merging
+ *   --dry-run=1         print the commands and exit
+ */
+
+#include "jamming-trace-file.h"
+#include "jamming-tool-options.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --program=PATH --jammer=TYPE"
+            << " --power=LIST --distance=LIST --output=FILE"
+            << " [--command=TEMPLATE] [--workers=N] [--shard-dir=DIR]"
+            << " [--keep-shards=1] [--dry-run=1]" << std::endl;
+}
+
+/**
+ * \brief Parses "a,b,c" or "start:stop:step" into a list of values.
+ *
+ * \returns False on a malformed list.
+ */
+bool
+ParseList (std::string const &text, std::vector<std::string> &values)
+{
+  values.clear ();
+  double start, stop, step;
+  char c1, c2;
+  std::istringstream range (text);
+  if (text.find (':') != std::string::npos)
+    {
+      if (!(range >> start >> c1 >> stop >> c2 >> step) || c1 != ':' ||
+          c2 != ':' || step <= 0 || stop < start)
+        {
+          return false;
+        }
+      // count steps up front so rounding cannot add or drop a point
+      uint32_t count = uint32_t ((stop - start) / step + 1e-9) + 1;
+      for (uint32_t i = 0; i < count; i++)
+        {
+          std::ostringstream os;
+          os.precision (12);
+          os << start + i * step;
+          values.push_back (os.str ());
+        }
+      return true;
+    }
+  std::istringstream list (text);
+  std::string value;
+  while (std::getline (list, value, ','))
+    {
+      char *end;
+      std::strtod (value.c_str (), &end);
+      if (value.empty () || *end != '\0')
+        {
+          return false;
+        }
+      values.push_back (value);
+    }
+  return !values.empty ();
+}
+
+/**
+ * \returns Template with every {key} replaced by its value.
+ */
+std::string
+Expand (std::string const &pattern,
+        const std::map<std::string, std::string> &values)
+{
+  std::string result;
+  size_t pos = 0;
+  while (pos < pattern.size ())
+    {
+      size_t open = pattern.find ('{', pos);
+      size_t close = open == std::string::npos ? open
+        : pattern.find ('}', open);
+      if (close == std::string::npos)
+        {
+          result += pattern.substr (pos);
+          break;
+        }
+      result += pattern.substr (pos, open - pos);
+      std::map<std::string, std::string>::const_iterator it =
+        values.find (pattern.substr (open + 1, close - open - 1));
+      result += it != values.end () ? it->second
+        : pattern.substr (open, close - open + 1);
+      pos = close + 1;
+    }
+  return result;
+}
+
+/**
+ * One grid cell of the sweep.
+ */
+struct Cell
+{
+  std::string command;
+  std::string shard;
+  pid_t pid;
+  int status;
+};
+
+/**
+ * \brief Runs all cells, at most workers at a time.
+ *
+ * \returns Number of cells that failed.
+ */
+uint32_t
+RunCells (std::vector<Cell> &cells, uint32_t workers)
+{
+  std::map<pid_t, uint32_t> running;
+  uint32_t next = 0, done = 0, failed = 0;
+  while (done < cells.size ())
+    {
+      while (running.size () < workers && next < cells.size ())
+        {
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              execl ("/bin/sh", "sh", "-c", cells[next].command.c_str (),
+                     (char *) NULL);
+              _exit (127);
+            }
+          if (pid < 0)
+            {
+              std::cerr << "fork failed: " << std::strerror (errno)
+                        << std::endl;
+              cells[next].status = -1;
+              failed++;
+              done++;
+            }
+          else
+            {
+              cells[next].pid = pid;
+              running[pid] = next;
+            }
+          next++;
+        }
+      if (running.empty ())
+        {
+          continue;
+        }
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          std::cerr << "waitpid failed: " << std::strerror (errno)
+                    << std::endl;
+          return failed + running.size () + (cells.size () - next);
+        }
+      std::map<pid_t, uint32_t>::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      Cell &cell = cells[it->second];
+      cell.status = status;
+      running.erase (it);
+      done++;
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          failed++;
+          std::cerr << "FAILED: " << cell.command << std::endl;
+        }
+      std::cerr << "[" << done << "/" << cells.size () << "] "
+                << cell.shard << std::endl;
+    }
+  return failed;
+}
+
+/**
+ * \brief Appends all shards, in cell order, to one trace.
+ *
+ * \returns False if a shard cannot be read or the output cannot be written.
+ */
+bool
+MergeShards (const std::vector<Cell> &cells, std::string const &output)
+{
+  JammingTraceFile merged;
+  merged.Open (output, std::ios::out);
+  if (merged.Fail ())
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return false;
+    }
+  for (uint32_t i = 0; i < cells.size (); i++)
+    {
+      JammingTraceFile shard;
+      shard.Open (cells[i].shard, std::ios::in);
+      JammingTraceRecord record;
+      while (shard.Read (record))
+        {
+          merged.Write (record);
+        }
+      if (shard.Fail ())
+        {
+          std::cerr << "Cannot read shard " << cells[i].shard << std::endl;
+          return false;
+        }
+    }
+  merged.Close ();
+  return !merged.Fail ();
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string program, jammer, powerList, distanceList, output;
+  std::string command = "{program} --jammer={jammer} --txPower={power}"
+    " --distance={distance} --trace={trace}";
+  std::string shardDir = "sweep-shards";
+  uint32_t workers = sysconf (_SC_NPROCESSORS_ONLN);
+  bool keepShards = false, dryRun = false;
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if (ParseOption (argv[i], "program", program) ||
+          ParseOption (argv[i], "jammer", jammer) ||
+          ParseOption (argv[i], "power", powerList) ||
+          ParseOption (argv[i], "distance", distanceList) ||
+          ParseOption (argv[i], "output", output) ||
+          ParseOption (argv[i], "command", command) ||
+          ParseOption (argv[i], "shard-dir", shardDir))
+        {
+          continue;
+        }
+      if (ParseOption (argv[i], "workers", value))
+        {
+          workers = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "keep-shards", value))
+        {
+          keepShards = value == "1";
+        }
+      else if (ParseOption (argv[i], "dry-run", value))
+        {
+          dryRun = value == "1";
+        }
+      else
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+
+  std::vector<std::string> powers, distances;
+  if (jammer != "none" && jammer != "constant" && jammer != "reactive" &&
+      jammer != "random")
+    {
+      std::cerr << "Unknown jammer type '" << jammer << "'" << std::endl;
+      Usage (argv[0]);
+      return 1;
+    }
+  if (program.empty () && command.find ("{program}") != std::string::npos)
+    {
+      std::cerr << "The command needs --program=PATH" << std::endl;
+      Usage (argv[0]);
+      return 1;
+    }
+  if (output.empty () || workers == 0 || !ParseList (powerList, powers) ||
+      !ParseList (distanceList, distances))
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  std::vector<Cell> cells;
+  for (uint32_t p = 0; p < powers.size (); p++)
+    {
+      for (uint32_t d = 0; d < distances.size (); d++)
+        {
+          std::ostringstream index, shard;
+          index << cells.size ();
+          shard << shardDir << "/" << jammer << "-" << cells.size () << ".jtr";
+          std::map<std::string, std::string> values;
+          values["program"] = program;
+          values["jammer"] = jammer;
+          values["power"] = powers[p];
+          values["distance"] = distances[d];
+          values["trace"] = shard.str ();
+          values["cell"] = index.str ();
+          Cell cell;
+          cell.command = Expand (command, values);
+          cell.shard = shard.str ();
+          cell.pid = 0;
+          cell.status = 0;
+          cells.push_back (cell);
+        }
+    }
+
+  if (dryRun)
+    {
+      for (uint32_t i = 0; i < cells.size (); i++)
+        {
+          std::cout << cells[i].command << "\n";
+        }
+      return 0;
+    }
+
+  if (mkdir (shardDir.c_str (), 0755) != 0 && errno != EEXIST)
+    {
+      std::cerr << "Cannot create " << shardDir << ": "
+                << std::strerror (errno) << std::endl;
+      return 1;
+    }
+  std::cerr << "Running " << cells.size () << " cells on " << workers
+            << " workers" << std::endl;
+  uint32_t failed = RunCells (cells, workers);
+  if (failed > 0)
+    {
+      std::cerr << failed << " cells failed, shards kept in " << shardDir
+                << ", not merging" << std::endl;
+      return 1;
+    }
+  if (!MergeShards (cells, output))
+    {
+      return 1;
+    }
+  if (!keepShards)
+    {
+      for (uint32_t i = 0; i < cells.size (); i++)
+        {
+          std::remove (cells[i].shard.c_str ());
+        }
+      rmdir (shardDir.c_str ());
+    }
+  std::cerr << "Merged " << cells.size () << " shards into " << output
+            << std::endl;
+  return 0;
+}
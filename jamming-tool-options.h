@@ -0,0 +1,45 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_TOOL_OPTIONS_H
+#define JAMMING_TOOL_OPTIONS_H
+
+#include <cstring>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Command line parsing shared by the jamming-* tools.
+ *
+ * \returns True and sets value if arg is "--name=value".
+ */
+inline bool
+ParseOption (const char *arg, const char *name, std::string &value)
+{
+  size_t length = std::strlen (name);
+  if (std::strncmp (arg, "--", 2) != 0 ||
+      std::strncmp (arg + 2, name, length) != 0 || arg[2 + length] != '=')
+    {
+      return false;
+    }
+  value = arg + 3 + length;
+  return true;
+}
+
+} // namespace ns3
+
+#endif /* JAMMING_TOOL_OPTIONS_H */
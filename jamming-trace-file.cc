@@ -0,0 +1,421 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "jamming-trace-file.h"
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * \param rows Number of rows in a block.
+ * \returns Size in bytes of the block payload, including padding.
+ */
+uint64_t
+BlockPayloadSize (uint32_t rows)
+{
+  uint64_t size = rows * (sizeof (int64_t) + 4 * sizeof (double) +
+                          sizeof (uint32_t) + sizeof (uint8_t));
+  return (size + 7) & ~uint64_t (7);
+}
+
+} // anonymous namespace
+
+const uint32_t JammingTraceFile::MAGIC;
+const uint16_t JammingTraceFile::VERSION;
+const uint16_t JammingTraceFile::NUM_COLUMNS;
+const uint32_t JammingTraceFile::HEADER_SIZE;
+const uint32_t JammingTraceFile::BLOCK_HEADER_SIZE;
+const uint32_t JammingTraceFile::DEFAULT_BLOCK_ROWS;
+
+JammingTraceFile::JammingTraceFile ()
+  : m_mode (std::ios::in),
+    m_fail (false),
+    m_eof (false),
+    m_blockRows (DEFAULT_BLOCK_ROWS),
+    m_rows (0),
+    m_cursor (0)
+{
+}
+
+JammingTraceFile::~JammingTraceFile ()
+{
+  Close ();
+}
+
+void
+JammingTraceFile::Open (std::string const &filename, std::ios::openmode mode,
+                        uint32_t blockRows)
+{
+  Close ();
+  m_fail = false;
+  m_eof = false;
+  m_rows = 0;
+  m_cursor = 0;
+  m_mode = (mode & std::ios::out) ? std::ios::out : std::ios::in;
+
+  m_file.open (filename.c_str (), m_mode | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      m_fail = true;
+      return;
+    }
+
+  uint8_t header[HEADER_SIZE];
+  std::memset (header, 0, HEADER_SIZE);
+  if (m_mode == std::ios::out)
+    {
+      m_blockRows = blockRows > 0 ? blockRows : DEFAULT_BLOCK_ROWS;
+      uint32_t magic = MAGIC;
+      uint16_t version = VERSION;
+      uint16_t columns = NUM_COLUMNS;
+      std::memcpy (header, &magic, 4);
+      std::memcpy (header + 4, &version, 2);
+      std::memcpy (header + 6, &columns, 2);
+      std::memcpy (header + 8, &m_blockRows, 4);
+      m_file.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+      m_fail = m_file.fail ();
+      ResizeColumns (m_blockRows);
+      return;
+    }
+
+  m_file.read (reinterpret_cast<char *> (header), HEADER_SIZE);
+  uint32_t magic;
+  uint16_t version, columns;
+  std::memcpy (&magic, header, 4);
+  std::memcpy (&version, header + 4, 2);
+  std::memcpy (&columns, header + 6, 2);
+  std::memcpy (&m_blockRows, header + 8, 4);
+  if (m_file.fail () || magic != MAGIC || version != VERSION ||
+      columns != NUM_COLUMNS)
+    {
+      m_fail = true;
+    }
+}
+
+void
+JammingTraceFile::Close (void)
+{
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+  if (m_mode == std::ios::out)
+    {
+      FlushBlock ();
+    }
+  m_file.close ();
+}
+
+bool
+JammingTraceFile::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+JammingTraceFile::Eof (void) const
+{
+  return m_eof;
+}
+
+uint32_t
+JammingTraceFile::GetBlockRows (void) const
+{
+  return m_blockRows;
+}
+
+void
+JammingTraceFile::Write (const JammingTraceRecord &record)
+{
+  if (m_fail || m_mode != std::ios::out)
+    {
+      m_fail = true;
+      return;
+    }
+  m_timestamp[m_rows] = record.timestamp;
+  m_txPower[m_rows] = record.txPower;
+  m_distance[m_rows] = record.distance;
+  m_rss[m_rows] = record.rss;
+  m_pdr[m_rows] = record.pdr;
+  m_node[m_rows] = record.node;
+  m_jammerType[m_rows] = record.jammerType;
+  if (++m_rows == m_blockRows)
+    {
+      FlushBlock ();
+    }
+}
+
+void
+JammingTraceFile::Write (int64_t timestamp, uint32_t node,
+                         JammerType jammerType, double txPower,
+                         double distance, double rss, double pdr)
+{
+  JammingTraceRecord record;
+  record.timestamp = timestamp;
+  record.node = node;
+  record.jammerType = jammerType;
+  record.txPower = txPower;
+  record.distance = distance;
+  record.rss = rss;
+  record.pdr = pdr;
+  Write (record);
+}
+
+bool
+JammingTraceFile::Read (JammingTraceRecord &record)
+{
+  if (m_fail || m_mode != std::ios::in)
+    {
+      return false;
+    }
+  if (m_cursor == m_rows && !LoadBlock ())
+    {
+      return false;
+    }
+  record.timestamp = m_timestamp[m_cursor];
+  record.txPower = m_txPower[m_cursor];
+  record.distance = m_distance[m_cursor];
+  record.rss = m_rss[m_cursor];
+  record.pdr = m_pdr[m_cursor];
+  record.node = m_node[m_cursor];
+  record.jammerType = m_jammerType[m_cursor];
+  m_cursor++;
+  return true;
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+JammingTraceFile::FlushBlock (void)
+{
+  if (m_rows == 0)
+    {
+      return;
+    }
+  uint32_t blockHeader[2] = { m_rows, 0 };
+  m_file.write (reinterpret_cast<const char *> (blockHeader),
+                BLOCK_HEADER_SIZE);
+  m_file.write (reinterpret_cast<const char *> (&m_timestamp[0]),
+                m_rows * sizeof (int64_t));
+  m_file.write (reinterpret_cast<const char *> (&m_txPower[0]),
+                m_rows * sizeof (double));
+  m_file.write (reinterpret_cast<const char *> (&m_distance[0]),
+                m_rows * sizeof (double));
+  m_file.write (reinterpret_cast<const char *> (&m_rss[0]),
+                m_rows * sizeof (double));
+  m_file.write (reinterpret_cast<const char *> (&m_pdr[0]),
+                m_rows * sizeof (double));
+  m_file.write (reinterpret_cast<const char *> (&m_node[0]),
+                m_rows * sizeof (uint32_t));
+  m_file.write (reinterpret_cast<const char *> (&m_jammerType[0]),
+                m_rows * sizeof (uint8_t));
+  // pad block to 8 bytes so columns of the next block stay aligned
+  uint64_t written = m_rows * (sizeof (int64_t) + 4 * sizeof (double) +
+                               sizeof (uint32_t) + sizeof (uint8_t));
+  static const char padding[8] = { 0 };
+  m_file.write (padding, BlockPayloadSize (m_rows) - written);
+  m_fail = m_fail || m_file.fail ();
+  m_rows = 0;
+}
+
+bool
+JammingTraceFile::LoadBlock (void)
+{
+  uint32_t blockHeader[2];
+  m_file.read (reinterpret_cast<char *> (blockHeader), BLOCK_HEADER_SIZE);
+  if (m_file.gcount () == 0 && m_file.eof ())
+    {
+      m_eof = true;
+      return false;
+    }
+  uint32_t rows = blockHeader[0];
+  if (m_file.fail () || rows == 0 || rows > m_blockRows)
+    {
+      m_fail = true;
+      return false;
+    }
+  ResizeColumns (rows);
+  m_file.read (reinterpret_cast<char *> (&m_timestamp[0]),
+               rows * sizeof (int64_t));
+  m_file.read (reinterpret_cast<char *> (&m_txPower[0]),
+               rows * sizeof (double));
+  m_file.read (reinterpret_cast<char *> (&m_distance[0]),
+               rows * sizeof (double));
+  m_file.read (reinterpret_cast<char *> (&m_rss[0]), rows * sizeof (double));
+  m_file.read (reinterpret_cast<char *> (&m_pdr[0]), rows * sizeof (double));
+  m_file.read (reinterpret_cast<char *> (&m_node[0]),
+               rows * sizeof (uint32_t));
+  m_file.read (reinterpret_cast<char *> (&m_jammerType[0]),
+               rows * sizeof (uint8_t));
+  uint64_t read = rows * (sizeof (int64_t) + 4 * sizeof (double) +
+                          sizeof (uint32_t) + sizeof (uint8_t));
+  m_file.ignore (BlockPayloadSize (rows) - read);
+  if (m_file.fail ())
+    {
+      m_fail = true;
+      return false;
+    }
+  m_rows = rows;
+  m_cursor = 0;
+  return true;
+}
+
+void
+JammingTraceFile::ResizeColumns (uint32_t rows)
+{
+  m_timestamp.resize (rows);
+  m_txPower.resize (rows);
+  m_distance.resize (rows);
+  m_rss.resize (rows);
+  m_pdr.resize (rows);
+  m_node.resize (rows);
+  m_jammerType.resize (rows);
+}
+
+/*
+ * JammingTraceView
+ */
+
+JammingTraceView::JammingTraceView ()
+  : m_data (NULL),
+    m_size (0),
+    m_rows (0)
+{
+}
+
+JammingTraceView::~JammingTraceView ()
+{
+  Close ();
+}
+
+bool
+JammingTraceView::Open (std::string const &filename)
+{
+  Close ();
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t) JammingTraceFile::HEADER_SIZE)
+    {
+      close (fd);
+      return false;
+    }
+  void *data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      return false;
+    }
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  uint32_t magic, blockRows;
+  uint16_t version, columns;
+  std::memcpy (&magic, m_data, 4);
+  std::memcpy (&version, m_data + 4, 2);
+  std::memcpy (&columns, m_data + 6, 2);
+  std::memcpy (&blockRows, m_data + 8, 4);
+  if (magic != JammingTraceFile::MAGIC ||
+      version != JammingTraceFile::VERSION ||
+      columns != JammingTraceFile::NUM_COLUMNS)
+    {
+      Close ();
+      return false;
+    }
+
+  // walk the blocks once and record where each column starts
+  uint64_t offset = JammingTraceFile::HEADER_SIZE;
+  while (offset < m_size)
+    {
+      if (offset + JammingTraceFile::BLOCK_HEADER_SIZE > m_size)
+        {
+          Close ();
+          return false;
+        }
+      Block block;
+      std::memcpy (&block.rows, m_data + offset, 4);
+      offset += JammingTraceFile::BLOCK_HEADER_SIZE;
+      if (block.rows == 0 || block.rows > blockRows ||
+          offset + BlockPayloadSize (block.rows) > m_size)
+        {
+          Close ();
+          return false;
+        }
+      const uint8_t *column = m_data + offset;
+      block.timestamp = reinterpret_cast<const int64_t *> (column);
+      column += block.rows * sizeof (int64_t);
+      block.txPower = reinterpret_cast<const double *> (column);
+      column += block.rows * sizeof (double);
+      block.distance = reinterpret_cast<const double *> (column);
+      column += block.rows * sizeof (double);
+      block.rss = reinterpret_cast<const double *> (column);
+      column += block.rows * sizeof (double);
+      block.pdr = reinterpret_cast<const double *> (column);
+      column += block.rows * sizeof (double);
+      block.node = reinterpret_cast<const uint32_t *> (column);
+      column += block.rows * sizeof (uint32_t);
+      block.jammerType = column;
+      m_blocks.push_back (block);
+      m_rows += block.rows;
+      offset += BlockPayloadSize (block.rows);
+    }
+  return true;
+}
+
+void
+JammingTraceView::Close (void)
+{
+  if (m_data != NULL)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+    }
+  m_data = NULL;
+  m_size = 0;
+  m_blocks.clear ();
+  m_rows = 0;
+}
+
+uint32_t
+JammingTraceView::GetBlockCount (void) const
+{
+  return m_blocks.size ();
+}
+
+const JammingTraceView::Block &
+JammingTraceView::GetBlock (uint32_t index) const
+{
+  return m_blocks.at (index);
+}
+
+uint64_t
+JammingTraceView::GetRowCount (void) const
+{
+  return m_rows;
+}
+
+} // namespace ns3
@@ -0,0 +1,233 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef JAMMING_TRACE_FILE_H
+#define JAMMING_TRACE_FILE_H
+
+#include "jammer-type.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace ns3 {
+
+/**
+ * One row of a jamming trace: what a receiving node saw for one packet.
+ */
+struct JammingTraceRecord
+{
+  int64_t timestamp;    // simulation time, in nanoseconds
+  uint32_t node;        // id of the receiving node
+  uint8_t jammerType;   // JammerType of the jammer in the scenario
+  double txPower;       // jammer TX power, in Watts
+  double distance;      // jammer to receiver distance, in meters
+  double rss;           // RSS of the packet, in Watts
+  double pdr;           // PDR seen by the receiver
+};
+
+/**
+ * \brief Binary columnar jamming trace file.
+ *
+ * Replaces the rss_*.txt / pdr_*.txt pairs written by the jammer scenarios.
+ * Both values of a packet are kept in the same row, together with the sweep
+ * parameters, so no zipping by line number is needed afterwards.
+ *
+ * File layout (native byte order, every column starts 8-byte aligned):
+ *
+ *   header (32 bytes):
+ *     uint32 magic ("JTRC"), uint16 version, uint16 number of columns,
+ *     uint32 rows per block, uint32 reserved, 16 bytes reserved
+ *   blocks, each:
+ *     uint32 number of rows n, uint32 reserved
+ *     int64  timestamp[n]
+ *     double txPower[n], distance[n], rss[n], pdr[n]
+ *     uint32 node[n]
+ *     uint8  jammerType[n]
+ *     zero padding up to a multiple of 8 bytes
+ *
+ * Rows are buffered and written one block at a time. Every block except the
+ * last one holds exactly "rows per block" rows.
+ */
+class JammingTraceFile
+{
+public:
+  static const uint32_t MAGIC = 0x4352544a;       // "JTRC"
+  static const uint16_t VERSION = 1;
+  static const uint16_t NUM_COLUMNS = 7;
+  static const uint32_t HEADER_SIZE = 32;
+  static const uint32_t BLOCK_HEADER_SIZE = 8;
+  static const uint32_t DEFAULT_BLOCK_ROWS = 4096;
+
+  JammingTraceFile ();
+  ~JammingTraceFile ();
+
+  /**
+   * \brief Opens a trace file.
+   *
+   * \param filename Name of the file.
+   * \param mode std::ios::in to read an existing trace, std::ios::out to
+   * create a new one.
+   * \param blockRows Rows per block, only used when writing.
+   *
+   * Check Fail () afterwards.
+   */
+  void Open (std::string const &filename, std::ios::openmode mode,
+             uint32_t blockRows = DEFAULT_BLOCK_ROWS);
+
+  /**
+   * Flushes the pending block (when writing) and closes the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns True if the last operation on the file failed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \returns True if all rows have been read.
+   */
+  bool Eof (void) const;
+
+  /**
+   * \brief Appends one row.
+   *
+   * \param record Row to append.
+   */
+  void Write (const JammingTraceRecord &record);
+
+  /**
+   * \brief Appends one row.
+   */
+  void Write (int64_t timestamp, uint32_t node, JammerType jammerType,
+              double txPower, double distance, double rss, double pdr);
+
+  /**
+   * \brief Reads next row.
+   *
+   * \param record Filled with the row read.
+   * \returns False on end of file or error.
+   */
+  bool Read (JammingTraceRecord &record);
+
+  /**
+   * \returns Rows per block of the open file.
+   */
+  uint32_t GetBlockRows (void) const;
+
+private:
+  /**
+   * Writes buffered rows as one block.
+   */
+  void FlushBlock (void);
+
+  /**
+   * Loads next block into the column buffers.
+   */
+  bool LoadBlock (void);
+
+  /**
+   * Resizes all column buffers to the given number of rows.
+   */
+  void ResizeColumns (uint32_t rows);
+
+private:
+  std::fstream m_file;
+  std::ios::openmode m_mode;
+  bool m_fail;
+  bool m_eof;
+  uint32_t m_blockRows;       // rows per block
+  uint32_t m_rows;            // rows currently held in the column buffers
+  uint32_t m_cursor;          // next row to read from the column buffers
+  // column buffers of the current block
+  std::vector<int64_t> m_timestamp;
+  std::vector<double> m_txPower;
+  std::vector<double> m_distance;
+  std::vector<double> m_rss;
+  std::vector<double> m_pdr;
+  std::vector<uint32_t> m_node;
+  std::vector<uint8_t> m_jammerType;
+
+};
+
+/**
+ * \brief Read-only memory mapped view of a jamming trace file.
+ *
+ * Gives direct pointers into the column arrays of each block, so analysis
+ * code can work on the trace without parsing or copying it.
+ */
+class JammingTraceView
+{
+public:
+  /**
+   * Column pointers of one block.
+   */
+  struct Block
+  {
+    uint32_t rows;
+    const int64_t *timestamp;
+    const double *txPower;
+    const double *distance;
+    const double *rss;
+    const double *pdr;
+    const uint32_t *node;
+    const uint8_t *jammerType;
+  };
+
+  JammingTraceView ();
+  ~JammingTraceView ();
+
+  /**
+   * \brief Maps a trace file.
+   *
+   * \param filename Name of the file.
+   * \returns False if the file cannot be mapped or is not a valid trace.
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * Unmaps the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns Number of blocks in the file.
+   */
+  uint32_t GetBlockCount (void) const;
+
+  /**
+   * \param index Index of block.
+   * \returns Column pointers of the block.
+   */
+  const Block & GetBlock (uint32_t index) const;
+
+  /**
+   * \returns Total number of rows in the file.
+   */
+  uint64_t GetRowCount (void) const;
+
+private:
+  const uint8_t *m_data;    // start of mapping
+  size_t m_size;            // size of mapping
+  std::vector<Block> m_blocks;
+  uint64_t m_rows;
+
+};
+
+} // namespace ns3
+
+#endif /* JAMMING_TRACE_FILE_H */
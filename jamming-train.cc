@@ -0,0 +1,253 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Trains a random forest on a feature file written by jamming-preprocess,
+ * and writes it in the model format read by jamming-classify and
+ * RandomForestClassifier.
+ *
+ * Usage:
+ *   jamming-train --input=train.txt --output=forest.model --trees=100
+ *
+ * Options:
+ *   --input=FILE             "rss pdr label" lines, features already scaled
+ *   --output=FILE            model file
+ *   --trees=N                number of trees (default 100)
+ *   --max-depth=N            deepest leaf, 0 for no limit (default 0)
+ *   --min-samples-leaf=N     fewest samples in a leaf (default 1)
+ *   --seed=N                 seed of the bootstrap and feature draws
+ *                            (default 1)
+ *   --workers=N              training threads (default: number of cores)
+ *
+ * The model only depends on the samples and options, not on the number
+ * of workers.
+ */
+
+#include "random-forest-trainer.h"
+#include "jamming-tool-options.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace ns3;
+
+namespace {
+
+void
+Usage (const char *program)
+{
+  std::cerr << "Usage: " << program << " --input=FILE --output=FILE"
+            << " [--trees=N] [--max-depth=N] [--min-samples-leaf=N]"
+            << " [--seed=N] [--workers=N]" << std::endl;
+}
+
+/**
+ * Work-stealing pool of tree indices. Each worker owns a queue, filled
+ * round robin; it takes trees from the front of its own queue and, once
+ * that is empty, steals from the back of the others'. Bootstrap trees
+ * differ in size, so stealing keeps every worker busy until the last tree.
+ */
+class TreePool
+{
+public:
+  TreePool (uint32_t trees, uint32_t workers)
+    : m_steals (0)
+  {
+    for (uint32_t w = 0; w < workers; w++)
+      {
+        m_queues.push_back (std::unique_ptr<Queue> (new Queue ()));
+      }
+    for (uint32_t t = 0; t < trees; t++)
+      {
+        m_queues[t % workers]->trees.push_back (t);
+      }
+  }
+
+  /**
+   * \param worker Worker asking.
+   * \param tree Set to the tree to train.
+   * \returns False once every tree was handed out.
+   */
+  bool Next (uint32_t worker, uint32_t &tree)
+  {
+    {
+      Queue &own = *m_queues[worker];
+      std::lock_guard<std::mutex> lock (own.mutex);
+      if (!own.trees.empty ())
+        {
+          tree = own.trees.front ();
+          own.trees.pop_front ();
+          return true;
+        }
+    }
+    for (uint32_t i = 1; i < m_queues.size (); i++)
+      {
+        Queue &victim = *m_queues[(worker + i) % m_queues.size ()];
+        std::lock_guard<std::mutex> lock (victim.mutex);
+        if (!victim.trees.empty ())
+          {
+            tree = victim.trees.back ();
+            victim.trees.pop_back ();
+            m_steals++;
+            return true;
+          }
+      }
+    return false;
+  }
+
+  uint32_t GetStealCount (void) const
+  {
+    return m_steals;
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<uint32_t> trees;
+  };
+
+  std::vector<std::unique_ptr<Queue> > m_queues;
+  std::atomic<uint32_t> m_steals;
+};
+
+} // anonymous namespace
+
+int
+main (int argc, char *argv[])
+{
+  std::string input, output;
+  uint32_t trees = 100;
+  uint32_t maxDepth = 0;
+  uint32_t minSamplesLeaf = 1;
+  uint32_t seed = 1;
+  uint32_t workers = std::max (1u, std::thread::hardware_concurrency ());
+
+  for (int i = 1; i < argc; i++)
+    {
+      std::string value;
+      if (ParseOption (argv[i], "input", input) ||
+          ParseOption (argv[i], "output", output))
+        {
+          continue;
+        }
+      if (ParseOption (argv[i], "trees", value))
+        {
+          trees = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "max-depth", value))
+        {
+          maxDepth = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "min-samples-leaf", value))
+        {
+          minSamplesLeaf = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "seed", value))
+        {
+          seed = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else if (ParseOption (argv[i], "workers", value))
+        {
+          workers = std::strtoul (value.c_str (), NULL, 10);
+        }
+      else
+        {
+          Usage (argv[0]);
+          return 1;
+        }
+    }
+  if (input.empty () || output.empty () || trees == 0 ||
+      minSamplesLeaf == 0 || workers == 0)
+    {
+      Usage (argv[0]);
+      return 1;
+    }
+
+  std::vector<JammingSample> samples;
+  if (!ReadSamples (input, samples) || samples.empty ())
+    {
+      std::cerr << "Cannot read samples from " << input << std::endl;
+      return 1;
+    }
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now ();
+  RandomForestTrainer trainer;
+  trainer.SetTreeCount (trees);
+  trainer.SetMaxDepth (maxDepth);
+  trainer.SetMinSamplesLeaf (minSamplesLeaf);
+  trainer.SetSeed (seed);
+  trainer.SetSamples (samples);
+  double presortSeconds = std::chrono::duration<double> (
+      std::chrono::steady_clock::now () - start).count ();
+
+  TreeEnsembleModel model;
+  trainer.InitModel (model);
+  TreePool pool (trees, workers);
+  std::vector<std::thread> threads;
+  for (uint32_t w = 0; w < workers; w++)
+    {
+      threads.push_back (std::thread ([&, w] ()
+        {
+          uint32_t tree;
+          while (pool.Next (w, tree))
+            {
+              trainer.TrainTree (tree, model.trees[tree]);
+            }
+        }));
+    }
+  for (uint32_t w = 0; w < workers; w++)
+    {
+      threads[w].join ();
+    }
+  double seconds = std::chrono::duration<double> (
+      std::chrono::steady_clock::now () - start).count ();
+
+  std::string error;
+  if (!model.Validate (error))
+    {
+      std::cerr << "Invalid model: " << error << std::endl;
+      return 1;
+    }
+  std::ofstream file (output.c_str ());
+  model.Write (file);
+  file.close ();
+  if (file.fail ())
+    {
+      std::cerr << "Cannot write " << output << std::endl;
+      return 1;
+    }
+
+  uint64_t nodes = 0;
+  for (uint32_t t = 0; t < trees; t++)
+    {
+      nodes += model.trees[t].nodes.size ();
+    }
+  std::cout << "Trained " << trees << " trees (" << nodes << " nodes) on "
+            << samples.size () << " samples in " << seconds * 1e3 << " ms ("
+            << presortSeconds * 1e3 << " ms presorting), " << workers
+            << " workers, " << pool.GetStealCount () << " steals"
+            << std::endl;
+  return 0;
+}
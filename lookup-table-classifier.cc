@@ -0,0 +1,255 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lookup-table-classifier.h"
+#include "ns3/assert.h"
+#include <algorithm>
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * Features are compared as floats and cell indices are rounded, so a
+ * threshold this close to a cell still counts as inside it.
+ */
+const double EDGE_MARGIN = 1e-6;
+
+/**
+ * \returns For each of n equal cells of [0, 1], true if no threshold lies
+ * in it.
+ */
+std::vector<bool>
+FindConstantCells (std::vector<double> thresholds, uint32_t n)
+{
+  std::sort (thresholds.begin (), thresholds.end ());
+  std::vector<bool> constant (n);
+  for (uint32_t c = 0; c < n; c++)
+    {
+      double low = double (c) / n - EDGE_MARGIN;
+      double high = double (c + 1) / n + EDGE_MARGIN;
+      std::vector<double>::const_iterator t =
+        std::lower_bound (thresholds.begin (), thresholds.end (), low);
+      constant[c] = t == thresholds.end () || *t > high;
+    }
+  return constant;
+}
+
+} // anonymous namespace
+
+const uint8_t LookupTableClassifier::BOUNDARY;
+
+LookupTableClassifier::LookupTableClassifier (Ptr<JammingClassifier> exact,
+                                              uint32_t rssCells,
+                                              uint32_t pdrCells,
+                                              uint32_t probesPerAxis)
+  : m_exact (exact),
+    m_rssCells (rssCells),
+    m_pdrCells (pdrCells),
+    m_boundaryCells (0),
+    m_isExact (true)
+{
+  NS_ASSERT (exact != NULL);
+  NS_ASSERT (rssCells > 0 && pdrCells > 0);
+  NS_ASSERT (probesPerAxis == 0 || probesPerAxis >= 2);
+  std::vector<double> rssThresholds, pdrThresholds;
+  if (m_exact->GetSplitThresholds (rssThresholds, pdrThresholds))
+    {
+      BuildFromThresholds (rssThresholds, pdrThresholds);
+    }
+  else if (probesPerAxis > 0)
+    {
+      BuildFromProbes (probesPerAxis);
+      m_isExact = false;
+    }
+  else
+    {
+      m_table.assign (m_rssCells * m_pdrCells, BOUNDARY);
+      m_boundaryCells = m_table.size ();
+    }
+}
+
+LookupTableClassifier::~LookupTableClassifier ()
+{
+}
+
+JammerType
+LookupTableClassifier::Classify (const JammingFeature &feature) const
+{
+  uint8_t label = Lookup (feature);
+  if (label != BOUNDARY)
+    {
+      return JammerType (label);
+    }
+  return m_exact->Classify (feature);
+}
+
+void
+LookupTableClassifier::ClassifyBatch (const JammingFeature *features,
+                                      uint8_t *labels, uint32_t n) const
+{
+  std::vector<uint32_t> misses;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      labels[i] = Lookup (features[i]);
+      if (labels[i] == BOUNDARY)
+        {
+          misses.push_back (i);
+        }
+    }
+  if (misses.empty ())
+    {
+      return;
+    }
+  std::vector<JammingFeature> missFeatures (misses.size ());
+  std::vector<uint8_t> missLabels (misses.size ());
+  for (uint32_t i = 0; i < misses.size (); i++)
+    {
+      missFeatures[i] = features[misses[i]];
+    }
+  m_exact->ClassifyBatch (&missFeatures[0], &missLabels[0], misses.size ());
+  for (uint32_t i = 0; i < misses.size (); i++)
+    {
+      labels[misses[i]] = missLabels[i];
+    }
+}
+
+double
+LookupTableClassifier::GetBoundaryFraction (void) const
+{
+  return double (m_boundaryCells) / m_table.size ();
+}
+
+bool
+LookupTableClassifier::IsExact (void) const
+{
+  return m_isExact;
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+LookupTableClassifier::BuildFromThresholds (
+  const std::vector<double> &rssThresholds,
+  const std::vector<double> &pdrThresholds)
+{
+  std::vector<bool> rssConstant = FindConstantCells (rssThresholds,
+                                                     m_rssCells);
+  std::vector<bool> pdrConstant = FindConstantCells (pdrThresholds,
+                                                     m_pdrCells);
+  // the model is constant on a cell, so its center gives the label
+  std::vector<uint32_t> cells;
+  std::vector<JammingFeature> centers;
+  for (uint32_t cy = 0; cy < m_pdrCells; cy++)
+    {
+      for (uint32_t cx = 0; cx < m_rssCells; cx++)
+        {
+          if (rssConstant[cx] && pdrConstant[cy])
+            {
+              JammingFeature center;
+              center.rss = (cx + 0.5) / m_rssCells;
+              center.pdr = (cy + 0.5) / m_pdrCells;
+              cells.push_back (cy * m_rssCells + cx);
+              centers.push_back (center);
+            }
+        }
+    }
+
+  m_table.assign (m_rssCells * m_pdrCells, BOUNDARY);
+  m_boundaryCells = m_table.size () - cells.size ();
+  if (cells.empty ())
+    {
+      return;
+    }
+  std::vector<uint8_t> labels (cells.size ());
+  m_exact->ClassifyBatch (&centers[0], &labels[0], cells.size ());
+  for (uint32_t i = 0; i < cells.size (); i++)
+    {
+      m_table[cells[i]] = labels[i];
+    }
+}
+
+void
+LookupTableClassifier::BuildFromProbes (uint32_t probesPerAxis)
+{
+  // Probe lattice shared by neighbouring cells: a cell owns
+  // (probesPerAxis - 1) steps along each axis plus the closing edge.
+  uint32_t steps = probesPerAxis - 1;
+  uint32_t rssPoints = m_rssCells * steps + 1;
+  uint32_t pdrPoints = m_pdrCells * steps + 1;
+  std::vector<JammingFeature> probes (rssPoints * pdrPoints);
+  for (uint32_t y = 0; y < pdrPoints; y++)
+    {
+      for (uint32_t x = 0; x < rssPoints; x++)
+        {
+          probes[y * rssPoints + x].rss = double (x) / (rssPoints - 1);
+          probes[y * rssPoints + x].pdr = double (y) / (pdrPoints - 1);
+        }
+    }
+  std::vector<uint8_t> probeLabels (probes.size ());
+  m_exact->ClassifyBatch (&probes[0], &probeLabels[0], probes.size ());
+
+  m_table.assign (m_rssCells * m_pdrCells, BOUNDARY);
+  m_boundaryCells = 0;
+  for (uint32_t cy = 0; cy < m_pdrCells; cy++)
+    {
+      for (uint32_t cx = 0; cx < m_rssCells; cx++)
+        {
+          uint8_t label = probeLabels[cy * steps * rssPoints + cx * steps];
+          bool uniform = true;
+          for (uint32_t y = cy * steps; uniform && y <= (cy + 1) * steps; y++)
+            {
+              for (uint32_t x = cx * steps; x <= (cx + 1) * steps; x++)
+                {
+                  if (probeLabels[y * rssPoints + x] != label)
+                    {
+                      uniform = false;
+                      break;
+                    }
+                }
+            }
+          if (uniform)
+            {
+              m_table[cy * m_rssCells + cx] = label;
+            }
+          else
+            {
+              m_boundaryCells++;
+            }
+        }
+    }
+}
+
+uint8_t
+LookupTableClassifier::Lookup (const JammingFeature &feature) const
+{
+  // NaN fails both tests, so it falls back to the exact model too
+  if (!(feature.rss >= 0.0 && feature.rss <= 1.0 &&
+        feature.pdr >= 0.0 && feature.pdr <= 1.0))
+    {
+      return BOUNDARY;
+    }
+  uint32_t x = uint32_t (feature.rss * m_rssCells);
+  uint32_t y = uint32_t (feature.pdr * m_pdrCells);
+  // 1.0 belongs to the last cell
+  x = x < m_rssCells ? x : m_rssCells - 1;
+  y = y < m_pdrCells ? y : m_pdrCells - 1;
+  return m_table[y * m_rssCells + x];
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOOKUP_TABLE_CLASSIFIER_H
+#define LOOKUP_TABLE_CLASSIFIER_H
+
+#include "jamming-classifier.h"
+
+namespace ns3 {
+
+/**
+ * \brief Rasterized classifier over the scaled (RSS, PDR) plane.
+ *
+ * The decision of an exact model is precomputed over a grid covering
+ * [0, 1] x [0, 1]. A cell where the decision is constant stores that label,
+ * and queries falling in it are answered by a single table lookup. All
+ * other cells are answered by the exact model, as are features outside the
+ * unit square.
+ *
+ * For models that report their split thresholds (tree ensembles) a cell is
+ * constant when no threshold falls inside it, so the table answers exactly
+ * as the model. Other models can only be rasterized approximately: with
+ * probesPerAxis > 0 each cell is probed on a lattice of samples (corners
+ * included) and stores the label if all probes agree, although the class
+ * region may still cut through the cell between probes. This is off by
+ * default, and without it every cell of such a model defers to the exact
+ * model.
+ */
+class LookupTableClassifier : public JammingClassifier
+{
+public:
+  static const uint8_t BOUNDARY = 0xff;   // cell label deferring to exact model
+
+  /**
+   * \param exact Exact model, also used near class boundaries.
+   * \param rssCells Number of grid cells along the RSS axis.
+   * \param pdrCells Number of grid cells along the PDR axis.
+   * \param probesPerAxis Probes along each axis of a cell, corners included
+   * (0, or at least 2). Only used if exact reports no split thresholds; 0
+   * disables the approximate table.
+   */
+  LookupTableClassifier (Ptr<JammingClassifier> exact, uint32_t rssCells = 256,
+                         uint32_t pdrCells = 256, uint32_t probesPerAxis = 0);
+  virtual ~LookupTableClassifier ();
+
+  virtual JammerType Classify (const JammingFeature &feature) const;
+
+  /**
+   * \brief Classifies a batch of features.
+   *
+   * Table hits are answered in one pass; the misses are then handed to the
+   * exact model as one batch.
+   */
+  virtual void ClassifyBatch (const JammingFeature *features, uint8_t *labels,
+                              uint32_t n) const;
+
+  /**
+   * \returns Fraction of grid cells that defer to the exact model.
+   */
+  double GetBoundaryFraction (void) const;
+
+  /**
+   * \returns False if the table was filled from probes and may disagree
+   * with the exact model.
+   */
+  bool IsExact (void) const;
+
+private:
+  /**
+   * Marks the cells between split thresholds and labels them.
+   */
+  void BuildFromThresholds (const std::vector<double> &rssThresholds,
+                            const std::vector<double> &pdrThresholds);
+
+  /**
+   * Evaluates the exact model on the probe lattice and fills the table.
+   */
+  void BuildFromProbes (uint32_t probesPerAxis);
+
+  /**
+   * \returns Table entry for feature, BOUNDARY if the exact model is needed.
+   */
+  uint8_t Lookup (const JammingFeature &feature) const;
+
+private:
+  Ptr<JammingClassifier> m_exact;
+  uint32_t m_rssCells;
+  uint32_t m_pdrCells;
+  std::vector<uint8_t> m_table;   // row major, one row per PDR cell
+  uint32_t m_boundaryCells;
+  bool m_isExact;
+
+};
+
+} // namespace ns3
+
+#endif /* LOOKUP_TABLE_CLASSIFIER_H */
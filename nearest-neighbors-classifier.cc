@@ -0,0 +1,299 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nearest-neighbors-classifier.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+namespace {
+
+// KNeighborsClassifier's default leaf_size
+const uint32_t LEAF_SIZE = 30;
+
+/**
+ * Orders training indices by one coordinate, then index, as sklearn's
+ * partition_node_indices.
+ */
+struct AxisLess
+{
+  const std::vector<JammingSample> *samples;
+  uint32_t axis;
+
+  bool operator() (uint32_t a, uint32_t b) const
+  {
+    double x = Coordinate ((*samples)[a].feature, axis);
+    double y = Coordinate ((*samples)[b].feature, axis);
+    return x == y ? a < b : x < y;
+  }
+
+  static double Coordinate (const JammingFeature &feature, uint32_t axis)
+  {
+    return axis == 0 ? feature.rss : feature.pdr;
+  }
+};
+
+} // anonymous namespace
+
+NearestNeighborsClassifier::NearestNeighborsClassifier (
+  const std::vector<JammingSample> &samples, uint32_t k)
+{
+  NS_ASSERT (!samples.empty ());
+  NS_ASSERT (k > 0);
+  m_k = std::min<uint32_t> (k, samples.size ());
+
+  // 1 + floor (log2 (leaves)) levels, leaving LEAF_SIZE to 2 * LEAF_SIZE
+  // samples per leaf
+  uint32_t levels = 1;
+  for (double leaves = (samples.size () - 1) / double (LEAF_SIZE);
+       leaves >= 2.0; leaves /= 2.0)
+    {
+      levels++;
+    }
+  m_nodes.resize ((1u << levels) - 1);
+
+  m_labels.resize (samples.size ());
+  std::vector<uint32_t> order (samples.size ());
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      NS_ASSERT (samples[i].label < JAMMER_TYPE_COUNT);
+      m_labels[i] = samples[i].label;
+      order[i] = i;
+    }
+  Build (samples, order, 0, 0, samples.size ());
+
+  m_features.resize (samples.size ());
+  m_index = order;
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      m_features[i] = samples[order[i]].feature;
+    }
+}
+
+NearestNeighborsClassifier::~NearestNeighborsClassifier ()
+{
+}
+
+uint32_t
+NearestNeighborsClassifier::GetK (void) const
+{
+  return m_k;
+}
+
+uint32_t
+NearestNeighborsClassifier::GetSampleCount (void) const
+{
+  return m_labels.size ();
+}
+
+uint8_t
+NearestNeighborsClassifier::GetLabel (uint32_t index) const
+{
+  return m_labels[index];
+}
+
+void
+NearestNeighborsClassifier::Build (const std::vector<JammingSample> &samples,
+                                   std::vector<uint32_t> &order,
+                                   uint32_t node, uint32_t start, uint32_t end)
+{
+  Node &info = m_nodes[node];
+  info.start = start;
+  info.end = end;
+  for (uint32_t axis = 0; axis < 2; axis++)
+    {
+      info.low[axis] = HUGE_VAL;
+      info.high[axis] = -HUGE_VAL;
+      for (uint32_t i = start; i < end; i++)
+        {
+          double value = AxisLess::Coordinate (samples[order[i]].feature,
+                                               axis);
+          info.low[axis] = std::min (info.low[axis], value);
+          info.high[axis] = std::max (info.high[axis], value);
+        }
+    }
+  info.leaf = 2 * node + 1 >= m_nodes.size () || end - start < 2;
+  if (info.leaf)
+    {
+      return;
+    }
+
+  // split at the median of the widest axis, the first one on a tie
+  AxisLess less;
+  less.samples = &samples;
+  less.axis = 0;
+  if (info.high[1] - info.low[1] > info.high[0] - info.low[0])
+    {
+      less.axis = 1;
+    }
+  uint32_t middle = start + (end - start) / 2;
+  std::nth_element (order.begin () + start, order.begin () + middle,
+                    order.begin () + end, less);
+  Build (samples, order, 2 * node + 1, start, middle);
+  Build (samples, order, 2 * node + 2, middle, end);
+}
+
+double
+NearestNeighborsClassifier::BoxDistance (const JammingFeature &feature,
+                                         uint32_t node) const
+{
+  const Node &info = m_nodes[node];
+  double distance = 0.0;
+  for (uint32_t axis = 0; axis < 2; axis++)
+    {
+      double value = AxisLess::Coordinate (feature, axis);
+      // x + |x| is 2 max (x, 0), rounded as sklearn's min_rdist rounds it
+      double below = info.low[axis] - value;
+      double above = value - info.high[axis];
+      double gap = 0.5 * ((below + std::fabs (below)) +
+                          (above + std::fabs (above)));
+      distance += gap * gap;
+    }
+  return distance;
+}
+
+void
+NearestNeighborsClassifier::Push (Neighbor *heap, uint32_t k, double distance,
+                                  uint32_t index)
+{
+  if (distance >= heap[0].distance)
+    {
+      return;
+    }
+  // sift down from the root; a child equal to the new entry stays below it
+  uint32_t i = 0;
+  for (;;)
+    {
+      uint32_t left = 2 * i + 1;
+      uint32_t child = left;
+      if (left >= k)
+        {
+          break;
+        }
+      if (left + 1 < k && heap[left].distance < heap[left + 1].distance)
+        {
+          child = left + 1;
+        }
+      if (!(distance < heap[child].distance))
+        {
+          break;
+        }
+      heap[i] = heap[child];
+      i = child;
+    }
+  heap[i].distance = distance;
+  heap[i].index = index;
+}
+
+uint32_t
+NearestNeighborsClassifier::Search (const JammingFeature &feature,
+                                    uint32_t node, double bound,
+                                    Neighbor *heap, uint32_t k) const
+{
+  if (bound > heap[0].distance)
+    {
+      return 0;
+    }
+  const Node &info = m_nodes[node];
+  if (info.leaf)
+    {
+      for (uint32_t i = info.start; i < info.end; i++)
+        {
+          double dx = feature.rss - m_features[i].rss;
+          double dy = feature.pdr - m_features[i].pdr;
+          Push (heap, k, dx * dx + dy * dy, m_index[i]);
+        }
+      return info.end - info.start;
+    }
+  uint32_t first = 2 * node + 1;
+  uint32_t second = first + 1;
+  double firstBound = BoxDistance (feature, first);
+  double secondBound = BoxDistance (feature, second);
+  if (firstBound > secondBound)
+    {
+      std::swap (first, second);
+      std::swap (firstBound, secondBound);
+    }
+  return Search (feature, first, firstBound, heap, k) +
+    Search (feature, second, secondBound, heap, k);
+}
+
+uint32_t
+NearestNeighborsClassifier::Query (const JammingFeature &feature,
+                                   Neighbor *heap, uint32_t k) const
+{
+  for (uint32_t i = 0; i < k; i++)
+    {
+      heap[i].distance = HUGE_VAL;
+      heap[i].index = 0;
+    }
+  return Search (feature, 0, BoxDistance (feature, 0), heap, k);
+}
+
+uint8_t
+NearestNeighborsClassifier::Vote (const Neighbor *heap) const
+{
+  uint32_t votes[JAMMER_TYPE_COUNT] = { 0 };
+  for (uint32_t i = 0; i < m_k; i++)
+    {
+      votes[m_labels[heap[i].index]]++;
+    }
+  uint8_t best = 0;
+  for (uint32_t t = 1; t < JAMMER_TYPE_COUNT; t++)
+    {
+      if (votes[t] > votes[best])
+        {
+          best = t;
+        }
+    }
+  return best;
+}
+
+uint32_t
+NearestNeighborsClassifier::FindNeighbors (
+  const JammingFeature &feature, uint32_t k,
+  std::vector<Neighbor> &neighbors) const
+{
+  k = std::min<uint32_t> (k, m_labels.size ());
+  neighbors.resize (k);
+  uint32_t evaluations = Query (feature, &neighbors[0], k);
+  std::sort (neighbors.begin (), neighbors.end ());
+  return evaluations;
+}
+
+JammerType
+NearestNeighborsClassifier::Classify (const JammingFeature &feature) const
+{
+  std::vector<Neighbor> heap (m_k);
+  Query (feature, &heap[0], m_k);
+  return static_cast<JammerType> (Vote (&heap[0]));
+}
+
+void
+NearestNeighborsClassifier::ClassifyBatch (const JammingFeature *features,
+                                           uint8_t *labels, uint32_t n) const
+{
+  std::vector<Neighbor> heap (m_k);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Query (features[i], &heap[0], m_k);
+      labels[i] = Vote (&heap[0]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NEAREST_NEIGHBORS_CLASSIFIER_H
+#define NEAREST_NEIGHBORS_CLASSIFIER_H
+
+#include "jamming-classifier.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief k nearest neighbors classifier, as sklearn's KNeighborsClassifier
+ * with uniform weights, Euclidean distance and the default kd-tree.
+ *
+ * The kd-tree is built and searched the way sklearn's KDTree is, with a
+ * leaf size of 30: nodes split at the median of their widest axis, a query
+ * descends into the nearer child first and keeps the k nearest samples in
+ * sklearn's bounded max-heap. Samples tied at the k-th distance are then
+ * kept or dropped as sklearn does, so the predictions are sklearn's, not
+ * only up to ties. Distances are computed in double, as sklearn does.
+ *
+ * The prediction is the most frequent label among the k neighbors, the
+ * lowest label on a tie.
+ *
+ * Queries only read the classifier, so batches can be classified from
+ * several threads at once.
+ */
+class NearestNeighborsClassifier : public JammingClassifier
+{
+public:
+  /**
+   * Training sample found by a query.
+   */
+  struct Neighbor
+  {
+    double distance;    // squared
+    uint32_t index;     // training index
+
+    /**
+     * Orders by distance, then training index.
+     */
+    bool operator< (const Neighbor &other) const
+    {
+      return distance < other.distance ||
+        (distance == other.distance && index < other.index);
+    }
+  };
+
+  /**
+   * \param samples Training samples, scaled.
+   * \param k Number of neighbors.
+   */
+  NearestNeighborsClassifier (const std::vector<JammingSample> &samples,
+                              uint32_t k = 35);
+  virtual ~NearestNeighborsClassifier ();
+
+  virtual JammerType Classify (const JammingFeature &feature) const;
+
+  virtual void ClassifyBatch (const JammingFeature *features, uint8_t *labels,
+                              uint32_t n) const;
+
+  /**
+   * \brief Finds the nearest training samples.
+   *
+   * The neighbors are those a search for k keeps, ties included, so a
+   * search for a larger k does not always extend them.
+   *
+   * \param feature Scaled feature.
+   * \param k Number of neighbors, at most the training samples.
+   * \param neighbors Filled with the k nearest training samples, nearest
+   * first.
+   * \returns Number of distances computed.
+   */
+  uint32_t FindNeighbors (const JammingFeature &feature, uint32_t k,
+                          std::vector<Neighbor> &neighbors) const;
+
+  uint32_t GetK (void) const;
+
+  /**
+   * \returns Number of training samples.
+   */
+  uint32_t GetSampleCount (void) const;
+
+  /**
+   * \returns Label of a training sample.
+   */
+  uint8_t GetLabel (uint32_t index) const;
+
+private:
+  /**
+   * kd-tree node, covering a range of samples in tree order.
+   */
+  struct Node
+  {
+    uint32_t start;     // first sample
+    uint32_t end;       // one past the last sample
+    bool leaf;
+    double low[2];      // bounding box, RSS and PDR
+    double high[2];
+  };
+
+  /**
+   * \brief Builds the subtree of a node, as sklearn's
+   * BinaryTree._recursive_build.
+   *
+   * \param order Training indices, partitioned in place.
+   */
+  void Build (const std::vector<JammingSample> &samples,
+              std::vector<uint32_t> &order, uint32_t node, uint32_t start,
+              uint32_t end);
+
+  /**
+   * \brief Searches the subtree of a node, nearer child first, as sklearn's
+   * BinaryTree._query_single_depthfirst.
+   *
+   * \param bound Squared distance from the query to the node's box.
+   * \param heap Nearest samples so far, as sklearn's max-heap of k entries.
+   * \returns Number of distances computed.
+   */
+  uint32_t Search (const JammingFeature &feature, uint32_t node, double bound,
+                   Neighbor *heap, uint32_t k) const;
+
+  /**
+   * \brief Pushes a sample on a heap of k entries, as sklearn's heap_push:
+   * it replaces the farthest entry only if strictly nearer.
+   */
+  static void Push (Neighbor *heap, uint32_t k, double distance,
+                    uint32_t index);
+
+  /**
+   * \returns Squared distance from a feature to a node's bounding box.
+   */
+  double BoxDistance (const JammingFeature &feature, uint32_t node) const;
+
+  /**
+   * \brief Runs a query from the root.
+   *
+   * \param heap Filled with the k nearest samples, as a max-heap.
+   * \returns Number of distances computed.
+   */
+  uint32_t Query (const JammingFeature &feature, Neighbor *heap,
+                  uint32_t k) const;
+
+  /**
+   * \returns Label voted by the neighbors in heap.
+   */
+  uint8_t Vote (const Neighbor *heap) const;
+
+  uint32_t m_k;                 // neighbors used, at most the samples
+  std::vector<Node> m_nodes;    // complete binary tree, children of i at 2i+1
+  std::vector<JammingFeature> m_features;       // samples in tree order
+  std::vector<uint32_t> m_index;        // training index, in tree order
+  std::vector<uint8_t> m_labels;        // labels, by training index
+};
+
+} // namespace ns3
+
+#endif /* NEAREST_NEIGHBORS_CLASSIFIER_H */
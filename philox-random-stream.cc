@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "philox-random-stream.h"
+#include "ns3/random-variable.h"
+
+namespace ns3 {
+
+PhiloxRandomStream::PhiloxRandomStream ()
+{
+  SetStream (0, 0);
+}
+
+void
+PhiloxRandomStream::SetKey (uint32_t seed, uint32_t run, uint32_t node,
+                            uint32_t stream)
+{
+  m_key[0] = seed;
+  m_key[1] = run;
+  m_counter[0] = 0;
+  m_counter[1] = 0;
+  m_counter[2] = node;
+  m_counter[3] = stream;
+  m_used = 2;
+}
+
+void
+PhiloxRandomStream::SetStream (uint32_t node, uint32_t stream)
+{
+  SetKey (SeedManager::GetSeed (), SeedManager::GetRun (), node, stream);
+}
+
+void
+PhiloxRandomStream::Fill (double *values, uint32_t n, double min, double max)
+{
+  uint32_t i = 0;
+  // drain the current block first, so the sequence matches GetValue
+  while (i < n && m_used < 2)
+    {
+      values[i++] = GetValue (min, max);
+    }
+  double scale = (max - min) * (1.0 / 9007199254740992.0);
+  for (; i + 1 < n; i += 2)
+    {
+      Refill ();
+      values[i] = min + (m_output[0] >> 11) * scale;
+      values[i + 1] = min + (m_output[1] >> 11) * scale;
+      m_used = 2;
+    }
+  if (i < n)
+    {
+      values[i] = GetValue (min, max);
+    }
+}
+
+uint64_t
+PhiloxRandomStream::GetDrawCount (void) const
+{
+  uint64_t blocks = (uint64_t (m_counter[1]) << 32) | m_counter[0];
+  return blocks == 0 ? 0 : blocks * 2 - (2 - m_used);
+}
+
+void
+PhiloxRandomStream::Philox (uint32_t counter[4], const uint32_t key[2])
+{
+  const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+  uint32_t k0 = key[0], k1 = key[1];
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  for (uint32_t round = 0; round < 10; round++)
+    {
+      uint64_t p0 = uint64_t (M0) * c0;
+      uint64_t p1 = uint64_t (M1) * c2;
+      uint32_t n0 = uint32_t (p1 >> 32) ^ c1 ^ k0;
+      uint32_t n2 = uint32_t (p0 >> 32) ^ c3 ^ k1;
+      c1 = uint32_t (p1);
+      c3 = uint32_t (p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += W0;
+      k1 += W1;
+    }
+  counter[0] = c0;
+  counter[1] = c1;
+  counter[2] = c2;
+  counter[3] = c3;
+}
+
+void
+PhiloxRandomStream::Refill (void)
+{
+  uint32_t block[4] = { m_counter[0], m_counter[1], m_counter[2], m_counter[3] };
+  Philox (block, m_key);
+  m_output[0] = (uint64_t (block[1]) << 32) | block[0];
+  m_output[1] = (uint64_t (block[3]) << 32) | block[2];
+  m_used = 0;
+  // 64-bit block index
+  if (++m_counter[0] == 0)
+    {
+      m_counter[1]++;
+    }
+}
+
+} // namespace ns3
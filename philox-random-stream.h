@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PHILOX_RANDOM_STREAM_H
+#define PHILOX_RANDOM_STREAM_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Counter-based random stream (Philox4x32-10).
+ *
+ * The i-th draw is a pure function of (seed, run, node, stream, i): the key
+ * is the simulation seed and run number, and the counter holds the block
+ * index, the node id and a per-jammer stream number. A jammer's draws
+ * therefore do not depend on any other random variable in the simulation,
+ * nor on the order in which jammers draw, so a single sweep cell or node can
+ * be reproduced bit for bit in isolation.
+ */
+class PhiloxRandomStream
+{
+public:
+  /**
+   * Sets the key from the current SeedManager seed and run number.
+   */
+  PhiloxRandomStream ();
+
+  /**
+   * \brief Sets the stream and restarts it at the first draw.
+   *
+   * \param seed Simulation seed.
+   * \param run Simulation run number.
+   * \param node Node or jammer id.
+   * \param stream Stream number within the node.
+   */
+  void SetKey (uint32_t seed, uint32_t run, uint32_t node, uint32_t stream);
+
+  /**
+   * \brief Restarts the stream for a node and stream number, keyed by the
+   * current SeedManager seed and run number.
+   */
+  void SetStream (uint32_t node, uint32_t stream);
+
+  /**
+   * \returns Next 64 random bits.
+   */
+  inline uint64_t GetUint64 (void)
+  {
+    if (m_used == 2)
+      {
+        Refill ();
+      }
+    return m_output[m_used++];
+  }
+
+  /**
+   * \returns Uniform double in [0, 1), 53 random bits.
+   */
+  inline double GetValue (void)
+  {
+    return (GetUint64 () >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  /**
+   * \returns Uniform double in [min, max).
+   */
+  inline double GetValue (double min, double max)
+  {
+    return min + (max - min) * GetValue ();
+  }
+
+  /**
+   * \brief Fills values with uniform doubles in [min, max).
+   *
+   * Same values as n calls of GetValue (min, max).
+   */
+  void Fill (double *values, uint32_t n, double min, double max);
+
+  /**
+   * \returns Number of 64-bit values drawn since the stream was keyed.
+   */
+  uint64_t GetDrawCount (void) const;
+
+  /**
+   * \brief Philox4x32-10 block function.
+   *
+   * \param counter Counter, replaced by the output block.
+   * \param key Key.
+   */
+  static void Philox (uint32_t counter[4], const uint32_t key[2]);
+
+private:
+  void Refill (void);
+
+  uint32_t m_key[2];
+  uint32_t m_counter[4];    // block index (64 bits), node, stream
+  uint64_t m_output[2];     // current output block
+  uint32_t m_used;          // values of m_output already returned
+};
+
+} // namespace ns3
+
+#endif /* PHILOX_RANDOM_STREAM_H */
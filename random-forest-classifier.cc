@@ -0,0 +1,282 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "random-forest-classifier.h"
+#include <limits>
+#include <sstream>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+const uint32_t RandomForestClassifier::BLOCK_SIZE;
+
+RandomForestClassifier::RandomForestClassifier ()
+  : m_classes (0)
+{
+}
+
+RandomForestClassifier::~RandomForestClassifier ()
+{
+}
+
+bool
+RandomForestClassifier::SetModel (const TreeEnsembleModel &model,
+                                  std::string &error)
+{
+  if (!model.Validate (error))
+    {
+      return false;
+    }
+  if (model.kind != "forest" || model.features != 2 ||
+      model.outputs != model.classes || model.classes > JAMMER_TYPE_COUNT)
+    {
+      error = "expected a forest over (RSS, PDR) with one value per class";
+      return false;
+    }
+
+  m_classes = model.classes;
+  m_root.clear ();
+  m_depth.clear ();
+  m_feature.clear ();
+  m_threshold.clear ();
+  m_left.clear ();
+  m_leafOffset.clear ();
+  m_leafValues.clear ();
+
+  for (uint32_t t = 0; t < model.trees.size (); t++)
+    {
+      const DecisionTree &tree = model.trees[t];
+      int32_t base = m_feature.size ();
+      m_root.push_back (base);
+      m_depth.push_back (tree.GetDepth ());
+
+      /*
+       * Renumber nodes breadth first, giving the children of each internal
+       * node two adjacent slots. order[k] is the original index of new node
+       * base + k.
+       */
+      std::vector<int32_t> order (1, 0);
+      order.reserve (tree.nodes.size ());
+      m_feature.resize (base + tree.nodes.size ());
+      m_threshold.resize (base + tree.nodes.size ());
+      m_left.resize (base + tree.nodes.size ());
+      m_leafOffset.resize (base + tree.nodes.size ());
+      for (uint32_t k = 0; k < order.size (); k++)
+        {
+          const TreeNode &node = tree.nodes[order[k]];
+          int32_t index = base + k;
+          if (node.feature < 0)
+            {
+              // leaf: stay here whatever the feature value is
+              m_feature[index] = 0;
+              m_threshold[index] = std::numeric_limits<float>::infinity ();
+              m_left[index] = index;
+              m_leafOffset[index] = m_leafValues.size ();
+              const double *value = &tree.values[order[k] * model.outputs];
+              // normalize as sklearn's predict_proba does
+              double sum = 0.0;
+              for (uint32_t c = 0; c < m_classes; c++)
+                {
+                  sum += value[c];
+                }
+              sum = sum == 0.0 ? 1.0 : sum;
+              for (uint32_t c = 0; c < m_classes; c++)
+                {
+                  m_leafValues.push_back (value[c] / sum);
+                }
+              continue;
+            }
+          m_feature[index] = node.feature;
+          m_threshold[index] = FloatThresholdBelow (node.threshold);
+          m_left[index] = base + order.size ();
+          m_leafOffset[index] = 0;
+          order.push_back (node.left);
+          order.push_back (node.right);
+        }
+    }
+  return true;
+}
+
+bool
+RandomForestClassifier::Load (std::string const &filename, std::string &error)
+{
+  TreeEnsembleModel model;
+  return model.Load (filename, error) && SetModel (model, error);
+}
+
+JammerType
+RandomForestClassifier::Classify (const JammingFeature &feature) const
+{
+  uint8_t label;
+  ClassifyBlock (&feature, &label, 1);
+  return JammerType (label);
+}
+
+void
+RandomForestClassifier::ClassifyBatch (const JammingFeature *features,
+                                       uint8_t *labels, uint32_t n) const
+{
+  for (uint32_t i = 0; i < n; i += BLOCK_SIZE)
+    {
+      ClassifyBlock (features + i, labels + i,
+                     n - i < BLOCK_SIZE ? n - i : BLOCK_SIZE);
+    }
+}
+
+bool
+RandomForestClassifier::GetSplitThresholds (std::vector<double> &rss,
+                                            std::vector<double> &pdr) const
+{
+  rss.clear ();
+  pdr.clear ();
+  for (uint32_t i = 0; i < m_feature.size (); i++)
+    {
+      // leaves point to themselves
+      if (m_left[i] != int32_t (i))
+        {
+          (m_feature[i] == 0 ? rss : pdr).push_back (m_threshold[i]);
+        }
+    }
+  return true;
+}
+
+uint32_t
+RandomForestClassifier::GetTreeCount (void) const
+{
+  return m_root.size ();
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+RandomForestClassifier::WalkTree (uint32_t tree, const float *rss,
+                                  const float *pdr, int32_t *leaves,
+                                  uint32_t n) const
+{
+  const int32_t *feature = &m_feature[0];
+  const float *threshold = &m_threshold[0];
+  const int32_t *left = &m_left[0];
+  int32_t root = m_root[tree];
+  uint32_t depth = m_depth[tree];
+  uint32_t i = 0;
+
+#ifdef __AVX2__
+  const __m256i one = _mm256_set1_epi32 (1);
+  for (; i + 8 <= n; i += 8)
+    {
+      __m256i index = _mm256_set1_epi32 (root);
+      __m256 x0 = _mm256_loadu_ps (rss + i);
+      __m256 x1 = _mm256_loadu_ps (pdr + i);
+      for (uint32_t d = 0; d < depth; d++)
+        {
+          __m256i f = _mm256_i32gather_epi32 (feature, index, 4);
+          __m256 t = _mm256_i32gather_ps (threshold, index, 4);
+          __m256i l = _mm256_i32gather_epi32 (left, index, 4);
+          __m256 x = _mm256_blendv_ps (x0, x1, _mm256_castsi256_ps (
+                                         _mm256_cmpeq_epi32 (f, one)));
+          // all ones (-1) where x > t, so subtracting moves to the right child
+          __m256i right = _mm256_castps_si256 (_mm256_cmp_ps (x, t,
+                                                              _CMP_GT_OQ));
+          __m256i next = _mm256_sub_epi32 (l, right);
+          // leaves loop onto themselves: stop once no lane moves
+          __m256i moved = _mm256_xor_si256 (next, index);
+          index = next;
+          if (_mm256_testz_si256 (moved, moved))
+            {
+              break;
+            }
+        }
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (leaves + i), index);
+    }
+#endif
+
+  // scalar path: step all remaining samples one level at a time for ILP
+  for (uint32_t k = i; k < n; k++)
+    {
+      leaves[k] = root;
+    }
+  for (uint32_t d = 0; d < depth; d++)
+    {
+      int32_t moved = 0;
+      for (uint32_t k = i; k < n; k++)
+        {
+          int32_t index = leaves[k];
+          float x = feature[index] ? pdr[k] : rss[k];
+          leaves[k] = left[index] + (x > threshold[index]);
+          moved |= leaves[k] ^ index;
+        }
+      if (moved == 0)
+        {
+          break;
+        }
+    }
+}
+
+void
+RandomForestClassifier::ClassifyBlock (const JammingFeature *features,
+                                       uint8_t *labels, uint32_t n) const
+{
+  float rss[BLOCK_SIZE], pdr[BLOCK_SIZE];
+  int32_t leaves[BLOCK_SIZE];
+  double sum[BLOCK_SIZE * JAMMER_TYPE_COUNT];
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      rss[i] = static_cast<float> (features[i].rss);
+      pdr[i] = static_cast<float> (features[i].pdr);
+    }
+  for (uint32_t i = 0; i < n * m_classes; i++)
+    {
+      sum[i] = 0.0;
+    }
+
+  for (uint32_t t = 0; t < m_root.size (); t++)
+    {
+      WalkTree (t, rss, pdr, leaves, n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          const double *value = &m_leafValues[m_leafOffset[leaves[i]]];
+          for (uint32_t c = 0; c < m_classes; c++)
+            {
+              sum[i * m_classes + c] += value[c];
+            }
+        }
+    }
+
+  double trees = m_root.size ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      const double *s = &sum[i * m_classes];
+      uint32_t best = 0;
+      double bestValue = s[0] / trees;
+      for (uint32_t c = 1; c < m_classes; c++)
+        {
+          double value = s[c] / trees;
+          if (value > bestValue)
+            {
+              best = c;
+              bestValue = value;
+            }
+        }
+      labels[i] = best;
+    }
+}
+
+} // namespace ns3
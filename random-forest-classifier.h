@@ -0,0 +1,115 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RANDOM_FOREST_CLASSIFIER_H
+#define RANDOM_FOREST_CLASSIFIER_H
+
+#include "jamming-classifier.h"
+#include "tree-ensemble-model.h"
+
+namespace ns3 {
+
+/**
+ * \brief Flattened random forest inference engine.
+ *
+ * Loads a "forest" TreeEnsembleModel into contiguous structure-of-arrays
+ * node tables shared by all trees:
+ *  - nodes are renumbered so the two children of a node are adjacent, and a
+ *    step down the tree is "next = left + (x > threshold)",
+ *  - thresholds are stored as floats rounded down; features are compared as
+ *    floats, which gives exactly sklearn's float32 decisions,
+ *  - leaves point to themselves with an infinite threshold, so a fixed
+ *    number of steps (the tree depth) reaches the leaf of every sample
+ *    without branching.
+ *
+ * Batches are evaluated tree by tree so one tree's nodes stay in cache while
+ * all samples of the batch walk it. When built with AVX2, eight samples walk
+ * a tree at once using gathers and vector compares.
+ *
+ * Predictions match sklearn's RandomForestClassifier.predict: argmax of the
+ * mean leaf probabilities, ties going to the lowest class.
+ */
+class RandomForestClassifier : public JammingClassifier
+{
+public:
+  RandomForestClassifier ();
+  virtual ~RandomForestClassifier ();
+
+  /**
+   * \brief Loads a model.
+   *
+   * \param model A "forest" model over the two (RSS, PDR) features.
+   * \param error Set to a description of the problem on failure.
+   * \returns False if the model cannot be used.
+   */
+  bool SetModel (const TreeEnsembleModel &model, std::string &error);
+
+  /**
+   * \brief Loads a model file written by export-jamming-model.py or by the
+   * native trainer.
+   */
+  bool Load (std::string const &filename, std::string &error);
+
+  virtual JammerType Classify (const JammingFeature &feature) const;
+
+  virtual void ClassifyBatch (const JammingFeature *features, uint8_t *labels,
+                              uint32_t n) const;
+
+  virtual bool GetSplitThresholds (std::vector<double> &rss,
+                                   std::vector<double> &pdr) const;
+
+  /**
+   * \returns Number of trees.
+   */
+  uint32_t GetTreeCount (void) const;
+
+private:
+  /**
+   * \brief Walks one tree for a block of samples.
+   *
+   * \param tree Tree index.
+   * \param rss Scaled RSS of each sample, as float.
+   * \param pdr Scaled PDR of each sample, as float.
+   * \param leaves Filled with the leaf reached by each sample.
+   * \param n Number of samples, at most BLOCK_SIZE.
+   */
+  void WalkTree (uint32_t tree, const float *rss, const float *pdr,
+                 int32_t *leaves, uint32_t n) const;
+
+  /**
+   * Classifies at most BLOCK_SIZE samples.
+   */
+  void ClassifyBlock (const JammingFeature *features, uint8_t *labels,
+                      uint32_t n) const;
+
+private:
+  static const uint32_t BLOCK_SIZE = 64;    // samples evaluated together
+
+  uint32_t m_classes;
+  std::vector<int32_t> m_root;        // first node of each tree
+  std::vector<uint32_t> m_depth;      // depth of each tree
+  // node tables, all trees back to back
+  std::vector<int32_t> m_feature;
+  std::vector<float> m_threshold;
+  std::vector<int32_t> m_left;        // right child is m_left + 1
+  std::vector<uint32_t> m_leafOffset; // start of leaf probabilities
+  std::vector<double> m_leafValues;   // m_classes values per leaf
+
+};
+
+} // namespace ns3
+
+#endif /* RANDOM_FOREST_CLASSIFIER_H */
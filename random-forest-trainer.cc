@@ -0,0 +1,314 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "random-forest-trainer.h"
+#include "philox-random-stream.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+
+namespace {
+
+// feature values closer than this are not split, as in sklearn
+const double FEATURE_THRESHOLD = 1e-7;
+
+// features evaluated per split, sqrt of the two features as in sklearn
+const uint32_t MAX_FEATURES = 1;
+
+/**
+ * Node waiting to be grown: a range of the tree's sorted sample lists.
+ */
+struct PendingNode
+{
+  uint32_t begin;
+  uint32_t end;
+  uint32_t depth;
+  int32_t parent;       // -1 for the root
+  bool isLeft;          // true if the left child of parent
+};
+
+/**
+ * Best split found so far at a node.
+ */
+struct Split
+{
+  bool found;
+  uint32_t feature;
+  uint32_t end;         // end of the left part of the node's range
+  double threshold;
+  double proxy;         // sklearn's proxy impurity improvement
+};
+
+/**
+ * \returns Sum of squared class weights.
+ */
+inline double
+SquaredSum (const std::vector<double> &counts)
+{
+  double sum = 0.0;
+  for (uint32_t c = 0; c < counts.size (); c++)
+    {
+      sum += counts[c] * counts[c];
+    }
+  return sum;
+}
+
+} // anonymous namespace
+
+RandomForestTrainer::RandomForestTrainer ()
+  : m_trees (100),
+    m_maxDepth (0),
+    m_minSamplesSplit (2),
+    m_minSamplesLeaf (1),
+    m_seed (1)
+{
+}
+
+void
+RandomForestTrainer::SetSamples (const std::vector<JammingSample> &samples)
+{
+  m_columns = Create<TrainingColumns> (samples);
+}
+
+void
+RandomForestTrainer::SetColumns (Ptr<TrainingColumns> columns)
+{
+  m_columns = columns;
+}
+
+void
+RandomForestTrainer::SetTreeCount (uint32_t trees)
+{
+  m_trees = trees;
+}
+
+uint32_t
+RandomForestTrainer::GetTreeCount (void) const
+{
+  return m_trees;
+}
+
+void
+RandomForestTrainer::SetMaxDepth (uint32_t depth)
+{
+  m_maxDepth = depth;
+}
+
+void
+RandomForestTrainer::SetMinSamplesSplit (uint32_t samples)
+{
+  m_minSamplesSplit = samples;
+}
+
+void
+RandomForestTrainer::SetMinSamplesLeaf (uint32_t samples)
+{
+  NS_ASSERT (samples > 0);
+  m_minSamplesLeaf = samples;
+}
+
+void
+RandomForestTrainer::SetSeed (uint32_t seed)
+{
+  m_seed = seed;
+}
+
+void
+RandomForestTrainer::InitModel (TreeEnsembleModel &model) const
+{
+  model.kind = "forest";
+  model.classes = m_columns->GetClassCount ();
+  model.features = TrainingColumns::FEATURES;
+  model.outputs = model.classes;
+  model.init.clear ();
+  model.trees.clear ();
+  model.trees.resize (m_trees);
+}
+
+void
+RandomForestTrainer::TrainTree (uint32_t index, DecisionTree &tree) const
+{
+  NS_ASSERT (m_columns != NULL);
+  const uint32_t FEATURES = TrainingColumns::FEATURES;
+  const std::vector<uint8_t> &labels = m_columns->GetLabels ();
+  uint32_t classes = m_columns->GetClassCount ();
+  uint32_t n = labels.size ();
+  PhiloxRandomStream random;
+  random.SetKey (m_seed, 0, index, 0);
+
+  // bootstrap: n draws with replacement, kept as per-sample weights
+  std::vector<double> weight (n, 0.0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      weight[uint32_t (random.GetValue () * n)] += 1.0;
+    }
+  std::vector<uint32_t> order[FEATURES];
+  for (uint32_t f = 0; f < FEATURES; f++)
+    {
+      order[f].reserve (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          uint32_t sample = m_columns->GetSorted (f)[i];
+          if (weight[sample] > 0.0)
+            {
+              order[f].push_back (sample);
+            }
+        }
+    }
+
+  std::vector<uint8_t> goesLeft (n);
+  std::vector<uint32_t> buffer (order[0].size ());
+  std::vector<double> counts (classes);
+  std::vector<double> leftCounts (classes);
+  std::vector<double> rightCounts (classes);
+  uint32_t maxDepth = m_maxDepth == 0 ? std::numeric_limits<uint32_t>::max ()
+    : m_maxDepth;
+
+  tree.nodes.clear ();
+  tree.values.clear ();
+  std::vector<PendingNode> stack;
+  PendingNode root = { 0, uint32_t (order[0].size ()), 0, -1, false };
+  stack.push_back (root);
+  while (!stack.empty ())
+    {
+      // depth first, left child first: nodes come out in sklearn's order
+      PendingNode pending = stack.back ();
+      stack.pop_back ();
+      int32_t node = tree.nodes.size ();
+      tree.nodes.push_back (TreeNode ());
+      if (pending.parent >= 0)
+        {
+          TreeNode &parent = tree.nodes[pending.parent];
+          (pending.isLeft ? parent.left : parent.right) = node;
+        }
+
+      std::fill (counts.begin (), counts.end (), 0.0);
+      double total = 0.0;
+      for (uint32_t p = pending.begin; p < pending.end; p++)
+        {
+          uint32_t sample = order[0][p];
+          counts[labels[sample]] += weight[sample];
+          total += weight[sample];
+        }
+      tree.values.insert (tree.values.end (), counts.begin (), counts.end ());
+
+      uint32_t samples = pending.end - pending.begin;
+      double impurity = 1.0 - SquaredSum (counts) / (total * total);
+      Split best = { false, 0, 0, 0.0,
+                     -std::numeric_limits<double>::infinity () };
+      if (pending.depth < maxDepth && samples >= m_minSamplesSplit &&
+          samples >= 2 * m_minSamplesLeaf &&
+          impurity > std::numeric_limits<double>::epsilon ())
+        {
+          // draw features in random order until MAX_FEATURES non-constant
+          // ones were evaluated
+          uint32_t features[FEATURES];
+          for (uint32_t f = 0; f < FEATURES; f++)
+            {
+              features[f] = f;
+            }
+          uint32_t evaluated = 0;
+          for (uint32_t d = 0; d < FEATURES && evaluated < MAX_FEATURES; d++)
+            {
+              std::swap (features[d],
+                         features[d + random.GetUint64 () % (FEATURES - d)]);
+              uint32_t f = features[d];
+              const std::vector<uint32_t> &sorted = order[f];
+              const std::vector<float> &values = m_columns->GetValues (f);
+              if (values[sorted[pending.end - 1]] <=
+                  values[sorted[pending.begin]] + FEATURE_THRESHOLD)
+                {
+                  continue; // constant in this node
+                }
+              evaluated++;
+
+              std::fill (leftCounts.begin (), leftCounts.end (), 0.0);
+              double leftTotal = 0.0;
+              for (uint32_t p = pending.begin; p + 1 < pending.end; p++)
+                {
+                  uint32_t sample = sorted[p];
+                  leftCounts[labels[sample]] += weight[sample];
+                  leftTotal += weight[sample];
+                  double value = values[sample];
+                  double nextValue = values[sorted[p + 1]];
+                  uint32_t leftSamples = p + 1 - pending.begin;
+                  if (nextValue <= value + FEATURE_THRESHOLD ||
+                      leftSamples < m_minSamplesLeaf ||
+                      samples - leftSamples < m_minSamplesLeaf)
+                    {
+                      continue;
+                    }
+                  for (uint32_t c = 0; c < classes; c++)
+                    {
+                      rightCounts[c] = counts[c] - leftCounts[c];
+                    }
+                  double rightTotal = total - leftTotal;
+                  double leftGini = 1.0 - SquaredSum (leftCounts) /
+                    (leftTotal * leftTotal);
+                  double rightGini = 1.0 - SquaredSum (rightCounts) /
+                    (rightTotal * rightTotal);
+                  double proxy = -rightTotal * rightGini - leftTotal * leftGini;
+                  if (proxy > best.proxy)
+                    {
+                      best.found = true;
+                      best.feature = f;
+                      best.end = p + 1;
+                      best.proxy = proxy;
+                      best.threshold =
+                        TrainingColumns::Threshold (values[sample],
+                                                    values[sorted[p + 1]]);
+                    }
+                }
+            }
+        }
+
+      TreeNode &current = tree.nodes[node];
+      current.left = -1;
+      current.right = -1;
+      if (!best.found)
+        {
+          current.feature = -1;
+          current.threshold = 0.0;
+          continue;
+        }
+      current.feature = best.feature;
+      current.threshold = best.threshold;
+
+      TrainingColumns::Partition (order, best.feature, pending.begin,
+                                  best.end, pending.end, goesLeft, buffer);
+
+      PendingNode rightChild = { best.end, pending.end, pending.depth + 1,
+                                 node, false };
+      PendingNode leftChild = { pending.begin, best.end, pending.depth + 1,
+                                node, true };
+      stack.push_back (rightChild);
+      stack.push_back (leftChild);
+    }
+}
+
+void
+RandomForestTrainer::Train (TreeEnsembleModel &model) const
+{
+  InitModel (model);
+  for (uint32_t t = 0; t < m_trees; t++)
+    {
+      TrainTree (t, model.trees[t]);
+    }
+}
+
+} // namespace ns3
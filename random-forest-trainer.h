@@ -0,0 +1,118 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RANDOM_FOREST_TRAINER_H
+#define RANDOM_FOREST_TRAINER_H
+
+#include "training-columns.h"
+#include "tree-ensemble-model.h"
+#include "ns3/ptr.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Random forest trainer over scaled (RSS, PDR) samples, with the
+ * defaults of sklearn's RandomForestClassifier.
+ *
+ * Trees are grown as in sklearn: bootstrap samples (as per-sample
+ * weights), gini impurity, one randomly drawn feature per split (sqrt of
+ * two features), splits at the midpoint of adjacent float feature values,
+ * grown until the leaves are pure unless a depth or size limit applies.
+ * Leaves hold the bootstrap-weighted class counts. The random draws come
+ * from a PhiloxRandomStream keyed by the seed and the tree index, so a
+ * tree does not depend on which thread trains it or when.
+ *
+ * Both feature columns are sorted once, in TrainingColumns, built by
+ * SetSamples or shared through SetColumns. A tree keeps one sorted copy per
+ * feature, restricted to its in-bag samples, and a split stably partitions
+ * the node's range of each copy, so no node sorts again.
+ *
+ * TrainTree only reads the trainer and may run on several threads at once.
+ */
+class RandomForestTrainer
+{
+public:
+  RandomForestTrainer ();
+
+  /**
+   * \brief Sets the training set and sorts its feature columns.
+   *
+   * \param samples Scaled samples; labels are the class indices.
+   */
+  void SetSamples (const std::vector<JammingSample> &samples);
+
+  /**
+   * \brief Sets the training set to already sorted columns.
+   */
+  void SetColumns (Ptr<TrainingColumns> columns);
+
+  void SetTreeCount (uint32_t trees);
+  uint32_t GetTreeCount (void) const;
+
+  /**
+   * \param depth Deepest leaf, 0 for no limit (the default).
+   */
+  void SetMaxDepth (uint32_t depth);
+
+  /**
+   * \param samples Fewest distinct samples a node needs to be split
+   * (default 2).
+   */
+  void SetMinSamplesSplit (uint32_t samples);
+
+  /**
+   * \param samples Fewest distinct samples on each side of a split
+   * (default 1).
+   */
+  void SetMinSamplesLeaf (uint32_t samples);
+
+  /**
+   * \param seed Seed of the bootstrap and feature draws.
+   */
+  void SetSeed (uint32_t seed);
+
+  /**
+   * \brief Sets kind, classes, features and outputs of a forest model and
+   * sizes its tree list, for TrainTree to fill.
+   */
+  void InitModel (TreeEnsembleModel &model) const;
+
+  /**
+   * \brief Grows one tree.
+   *
+   * \param index Tree index, keys its random draws.
+   * \param tree Filled with the tree.
+   */
+  void TrainTree (uint32_t index, DecisionTree &tree) const;
+
+  /**
+   * \brief Grows all trees on the calling thread.
+   */
+  void Train (TreeEnsembleModel &model) const;
+
+private:
+  uint32_t m_trees;
+  uint32_t m_maxDepth;
+  uint32_t m_minSamplesSplit;
+  uint32_t m_minSamplesLeaf;
+  uint32_t m_seed;
+  Ptr<TrainingColumns> m_columns;
+};
+
+} // namespace ns3
+
+#endif /* RANDOM_FOREST_TRAINER_H */
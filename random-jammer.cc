@@ -19,6 +19,7 @@
  */
 
 #include "random-jammer.h"
+#include "jammer-trace.h"
 #include "ns3/simulator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
@@ -57,6 +58,38 @@ RandomJammer::GetTypeId (void)
                    RandomVariableValue (UniformVariable (0.0, 0.001)),
                    MakeRandomVariableAccessor (&RandomJammer::SetRandomVariable),
                    MakeRandomVariableChecker ())
+    .AddAttribute ("RandomJammerCounterRng",
+                   "Random jammer counter-based RNG flag, set to draw intervals from"
+                   " a stream keyed by seed, run, jammer id and RNG stream.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&RandomJammer::SetCounterRng,
+                                         &RandomJammer::GetCounterRng),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("RandomJammerRngStream",
+                   "Random jammer counter-based RNG stream number.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RandomJammer::SetRngStream,
+                                         &RandomJammer::GetRngStream),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RandomJammerMinInterval",
+                   "Random jammer smallest interval with counter-based RNG, in seconds.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&RandomJammer::SetMinInterval,
+                                       &RandomJammer::GetMinInterval),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("RandomJammerMaxInterval",
+                   "Random jammer largest interval with counter-based RNG, in seconds.",
+                   DoubleValue (0.001),
+                   MakeDoubleAccessor (&RandomJammer::SetMaxInterval,
+                                       &RandomJammer::GetMaxInterval),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("RandomJammerTimelineSize",
+                   "Number of random jammer intervals drawn ahead in one batch, 0 to"
+                   " draw one interval per burst.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RandomJammer::SetTimelineSize,
+                                         &RandomJammer::GetTimelineSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("RandomJammerRxTimeout",
                    "Random jammer RX timeout.",
                    TimeValue (Seconds (2.0)),
@@ -69,13 +102,25 @@ RandomJammer::GetTypeId (void)
                    MakeUintegerAccessor (&RandomJammer::SetReactToMitigation,
                                          &RandomJammer::GetReactToMitigation),
                    MakeUintegerChecker<bool> ())
+    .AddAttribute ("RandomJammerActivityHopping",
+                   "Random jammer activity hopping flag, set to hop to the channels where"
+                   " traffic was last seen instead of the next channel.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&RandomJammer::SetActivityHopping,
+                                         &RandomJammer::GetActivityHopping),
+                   MakeUintegerChecker<bool> ())
   ;
   return tid;
 }
 
 RandomJammer::RandomJammer ()
-  :  m_reactToMitigation (false),
-     m_reacting (false)
+  :  m_counterRng (false),
+     m_rngKeyed (false),
+     m_rngStream (0),
+     m_minInterval (0.0),
+     m_maxInterval (0.001),
+     m_timelineSize (0),
+     m_timelineNext (0)
 {
 }
 
@@ -134,6 +179,81 @@ RandomJammer::SetRandomVariable (RandomVariable random)
   m_randomJammingInterval = random;
 }
 
+void
+RandomJammer::SetCounterRng (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_counterRng = flag;
+}
+
+bool
+RandomJammer::GetCounterRng (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_counterRng;
+}
+
+void
+RandomJammer::SetRngStream (uint32_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rngStream = stream;
+  m_rngKeyed = false; // restart the stream on next draw
+}
+
+uint32_t
+RandomJammer::GetRngStream (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rngStream;
+}
+
+void
+RandomJammer::SetMinInterval (double interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  NS_ASSERT (interval >= 0);
+  m_minInterval = interval;
+}
+
+double
+RandomJammer::GetMinInterval (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_minInterval;
+}
+
+void
+RandomJammer::SetMaxInterval (double interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  NS_ASSERT (interval >= 0);
+  m_maxInterval = interval;
+}
+
+double
+RandomJammer::GetMaxInterval (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_maxInterval;
+}
+
+void
+RandomJammer::SetTimelineSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_timelineSize = size;
+  m_timeline.clear ();
+  m_timelineNext = 0;
+}
+
+uint32_t
+RandomJammer::GetTimelineSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_timelineSize;
+}
+
 void
 RandomJammer::SetRxTimeout (Time rxTimeout)
 {
@@ -162,6 +282,37 @@ RandomJammer::GetReactToMitigation (void) const
   return m_reactToMitigation;
 }
 
+void
+RandomJammer::SetActivityHopping (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_hopPolicy.SetEnabled (flag);
+}
+
+bool
+RandomJammer::GetActivityHopping (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_hopPolicy.IsEnabled ();
+}
+
+JammerStats
+RandomJammer::GetStats (void) const
+{
+  NS_LOG_FUNCTION (this);
+  JammerStats stats = m_stats;
+  stats.node = GetId ();
+  stats.jammerType = RANDOM_JAMMER;
+  return stats;
+}
+
+void
+RandomJammer::ResetStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stats.Reset ();
+}
+
 /*
  * Private functions start here.
  */
@@ -170,14 +321,14 @@ void
 RandomJammer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
 RandomJammer::DoStopJammer (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
@@ -188,25 +339,25 @@ RandomJammer::DoJamming (void)
 
   if (!IsJammerOn ())
     {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () << ", Jammer is OFF!");
+      JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_JAMMER_OFF, GetId (), 0, 0.0);
       return;
     }
 
-  NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                ", Sending jamming signal with power = " << m_txPower << " W" <<
-                ", At " << Simulator::Now ().GetSeconds () << "s");
-
   // send jamming signal
   double actualPower = m_utility->SendJammingSignal (m_txPower,
                                                      m_jammingDuration);
   if (actualPower != 0.0)
     {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", Jamming signal sent with power = " << actualPower <<
-                    " W");
+      m_stats.burstsSent++;
+      m_stats.energy += actualPower * m_jammingDuration.GetSeconds ();
+      JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_BURST_SENT, GetId (), 0,
+                    actualPower);
     }
   else
     {
+      JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_BURST_FAILED, GetId (), 0,
+                    m_txPower);
+      m_stats.burstsFailed++;
       NS_LOG_ERROR ("RandomJammer:At Node #" << GetId () <<
                     ", Failed to send jamming signal!");
     }
@@ -214,17 +365,9 @@ RandomJammer::DoJamming (void)
   /*
    * Schedule *first* RX timeout if react to mitigation is enabled. We know if
    * react to jamming mitigation is enabled, there should always be a RX timeout
-   * event scheduled. The RX timeout event can only "expire" if it's never been
-   * scheduled.
+   * event scheduled.
    */
-  if (m_reactToMitigation && m_rxTimeoutEvent.IsExpired())
-    {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", After jammer starts, scheduling RX timeout!");
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &RandomJammer::RxTimeoutHandler,
-                                              this);
-    }
+  StartRxTimeout ();
 
   m_reacting = false; // always reset reacting flag
 }
@@ -233,22 +376,9 @@ bool
 RandomJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
 {
   NS_LOG_FUNCTION (this << packet << startRss);
+  JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_RX_START, GetId (), 0, startRss);
 
-  if (m_reactToMitigation)
-    {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", React to mitigation enabled! Rescheduling RX Timeout");
-      m_rxTimeoutEvent.Cancel (); // cancel RX timeout event
-      // reschedule next RX timeout
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &RandomJammer::RxTimeoutHandler,
-                                              this);
-    }
-  else
-    {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", React to mitigation disabled!");
-    }
+  NotifyRxActivity ();
 
   return false; // Random Jammer always rejects the incoming packet
 }
@@ -257,8 +387,7 @@ bool
 RandomJammer::DoEndRxHandler (Ptr<Packet> packet, double averageRss)
 {
   NS_LOG_FUNCTION (this << packet << averageRss);
-  NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                ", Ignoring incoming packet!");
+  JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_RX_END, GetId (), 0, averageRss);
   return false;
 }
 
@@ -266,74 +395,82 @@ void
 RandomJammer::DoEndTxHandler (Ptr<Packet> packet, double txPower)
 {
   NS_LOG_FUNCTION (this << packet << txPower);
-  NS_LOG_DEBUG("RandomJammer:At Node #" << GetId () <<
-               ", Jamming packet is sent with power = " << txPower);
+  JAMMER_TRACE (RANDOM_JAMMER, JAMMER_TRACE_BURST_END, GetId (), 0, txPower);
   
-  m_jammingEvent.Cancel (); // cancel previously scheduled event
+  m_stats.Cancel (m_jammingEvent); // cancel previously scheduled event
 
-  if (m_reacting)
+  if (DeferJammingForChannelSwitch ())
     {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", Not sending jamming signal, jammer reacting to mitigation!");
-      // channel switch delay
-      Time delay = m_utility->GetPhyLayerInfo().channelSwitchDelay;
-      // schedule jamming after channel switch delay
-      m_jammingEvent = Simulator::Schedule (delay, &RandomJammer::DoJamming,
-                                            this);
       return; // do nothing if already reacting to mitigation
     }
 
   // calculate interval to sending next jamming burst
-  Time intervalToNextJamming = Seconds (m_randomJammingInterval.GetValue () +
+  Time intervalToNextJamming = Seconds (NextInterval () +
                                         m_jammingDuration.GetSeconds());
 
   // schedules send jamming signal in utility.
   m_jammingEvent = Simulator::Schedule (intervalToNextJamming,
                                         &RandomJammer::DoJamming, this);
+  m_stats.eventsScheduled++;
 }
 
 void
-RandomJammer::RxTimeoutHandler (void)
+RandomJammer::OnChannelHop (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () << ", RX timeout at " <<
-                Simulator::Now ().GetSeconds () << "s");
-  NS_ASSERT (m_utility != NULL);
-
-  m_rxTimeoutEvent.Cancel (); // cancel previously scheduled RX timeout
+  // intervals drawn for the old channel no longer apply
+  m_timelineNext = m_timeline.size ();
+}
 
-  if (!m_reactToMitigation)
+double
+RandomJammer::DrawInterval (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_counterRng)
     {
-      NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                    ", React to mitigation is turned OFF!");
-      return; // do nothing if react to mitigation flag is not set
+      return m_randomJammingInterval.GetValue ();
     }
+  return GetRng ().GetValue (m_minInterval, m_maxInterval);
+}
 
-  // calculate channel number
-  uint16_t currentChannel = m_utility->GetPhyLayerInfo ().currentChannel;
-  uint16_t nextChannel = currentChannel + 1;
-  if (nextChannel >= m_utility->GetPhyLayerInfo ().numOfChannels)
+PhiloxRandomStream &
+RandomJammer::GetRng (void)
+{
+  if (!m_rngKeyed)
     {
-      nextChannel = 1;  // wrap around and start form 1
+      // keyed on first draw, once the jammer id is known
+      m_rng.SetStream (GetId (), m_rngStream);
+      m_rngKeyed = true;
     }
+  return m_rng;
+}
 
-  NS_LOG_DEBUG ("RandomJammer:At Node #" << GetId () <<
-                ", Switching from channel " << currentChannel << " >-> " <<
-                nextChannel << ", At " << Simulator::Now ().GetSeconds () << "s");
-
-  // hop to next channel
-  m_utility->SwitchChannel (nextChannel);
-
-  /*
-   * Set reacting flag to indicate jammer is reacting. When the flag is set, no
-   * scheduling of new jamming event is allowed.
-   */
-  m_reacting = true;
-
-  // schedule next RX timeout
-  m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                          &RandomJammer::RxTimeoutHandler,
-                                          this);
+double
+RandomJammer::NextInterval (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_timelineSize == 0)
+    {
+      return DrawInterval ();
+    }
+  if (m_timelineNext == m_timeline.size ())
+    {
+      m_timeline.resize (m_timelineSize);
+      if (m_counterRng)
+        {
+          GetRng ().Fill (&m_timeline[0], m_timelineSize, m_minInterval,
+                          m_maxInterval);
+        }
+      else
+        {
+          for (uint32_t i = 0; i < m_timelineSize; i++)
+            {
+              m_timeline[i] = m_randomJammingInterval.GetValue ();
+            }
+        }
+      m_timelineNext = 0;
+    }
+  return m_timeline[m_timelineNext++];
 }
 
 } // namespace ns3
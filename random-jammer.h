@@ -22,17 +22,24 @@
 #define RANDOM_JAMMER_H
 
 #include "jammer.h"
+#include "jammer-stats.h"
+#include "jammer-mitigation.h"
+#include "channel-activity-hop-policy.h"
+#include "philox-random-stream.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include <vector>
 
 namespace ns3 {
 
 /**
  * Random Jammer.
  */
-class RandomJammer : public Jammer
+class RandomJammer : public Jammer, public JammerMitigation<RandomJammer, ChannelActivityHopPolicy>
 {
 public:
+  static const JammerType JAMMER_TYPE = RANDOM_JAMMER;
+
   static TypeId GetTypeId (void);
   RandomJammer ();
   virtual ~RandomJammer ();
@@ -59,12 +66,54 @@ public:
   void SetJammingDuration (Time duration);
   Time GetJammingDuration (void) const;
   void SetRandomVariable (RandomVariable random);
+  /**
+   * \brief Draws intervals from a counter-based stream instead of the
+   * RandomJammerRandomInterval variable.
+   *
+   * \param flag True to use the counter-based stream.
+   *
+   * The stream is keyed by the simulation seed and run, the jammer id and
+   * the RNG stream number, and draws uniformly from [min, max) interval.
+   */
+  void SetCounterRng (const bool flag);
+  bool GetCounterRng (void) const;
+  void SetRngStream (uint32_t stream);
+  uint32_t GetRngStream (void) const;
+  void SetMinInterval (double interval);
+  double GetMinInterval (void) const;
+  void SetMaxInterval (double interval);
+  double GetMaxInterval (void) const;
+  /**
+   * \brief Sets how many burst intervals are drawn ahead in one batch.
+   *
+   * \param size Number of pre-drawn intervals, 0 to draw one per burst.
+   *
+   * Pre-drawn intervals are discarded when the jammer hops channels.
+   */
+  void SetTimelineSize (uint32_t size);
+  uint32_t GetTimelineSize (void) const;
   void SetRxTimeout (Time rxTimeout);
   Time GetRxTimeout (void) const;
   void SetReactToMitigation (const bool flag);
   bool GetReactToMitigation (void) const;
+  /**
+   * \brief Enables activity-based channel hopping.
+   *
+   * \param flag True to hop to the channels where traffic was last seen, see
+   * ChannelActivityHopPolicy, instead of stepping to the next channel.
+   */
+  void SetActivityHopping (const bool flag);
+  bool GetActivityHopping (void) const;
+
+  /**
+   * \returns Work counters of this jammer since start or the last reset.
+   */
+  JammerStats GetStats (void) const;
+  void ResetStats (void);
 
 private:
+  friend class JammerMitigation<RandomJammer, ChannelActivityHopPolicy>;
+
   void DoDispose (void);
 
   /**
@@ -106,21 +155,43 @@ private:
   virtual void DoEndTxHandler (Ptr<Packet> packet, double txPower);
 
   /**
-   * Handles RX timeout event by hopping onto next channel.
+   * Called by JammerMitigation after each channel hop.
+   */
+  void OnChannelHop (void);
+
+  /**
+   * \returns Random interval between jamming bursts, in seconds.
+   */
+  double DrawInterval (void);
+
+  /**
+   * \returns Next interval between jamming bursts from the pre-drawn
+   * timeline, in seconds. Refills the timeline when it is used up.
+   */
+  double NextInterval (void);
+
+  /**
+   * \returns Counter-based stream, keyed for this jammer on first use.
    */
-  void RxTimeoutHandler (void);
+  PhiloxRandomStream &GetRng (void);
 
 private:
   Ptr<WirelessModuleUtility> m_utility;
   Ptr<EnergySource> m_source;
   RandomVariable m_randomJammingInterval; // random variable to use
+  bool m_counterRng;          // true to draw intervals from m_rng
+  PhiloxRandomStream m_rng;   // counter-based interval stream
+  bool m_rngKeyed;            // true once m_rng is keyed for this jammer
+  uint32_t m_rngStream;       // stream number within the jammer
+  double m_minInterval;       // counter-based interval bounds, in seconds
+  double m_maxInterval;
+  std::vector<double> m_timeline;   // pre-drawn intervals, in seconds
+  uint32_t m_timelineSize;    // number of intervals drawn per batch
+  uint32_t m_timelineNext;    // next unused interval in m_timeline
   double m_txPower;           // TX power
   Time m_jammingDuration;     // jamming duration
   EventId m_jammingEvent;     // jamming event
-  Time m_rxTimeout;           // RX timeout interval
-  EventId m_rxTimeoutEvent;   // RX timeout event
-  bool m_reactToMitigation;   // true if jammer is reacting to mitigation
-  bool m_reacting;    // flag indicating jammer is reacting to mitigation
+  JammerStats m_stats;        // work counters
 
 };  // class RandomJammer
 
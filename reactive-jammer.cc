@@ -19,11 +19,14 @@
  */
  
 #include "reactive-jammer.h"
+#include "jammer-trace.h"
 #include "ns3/simulator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
+#include <cmath>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("ReactiveJammer");
 
@@ -82,13 +85,62 @@ ReactiveJammer::GetTypeId (void)
                    MakeUintegerAccessor (&ReactiveJammer::SetReactToMitigation,
                                          &ReactiveJammer::GetReactToMitigation),
                    MakeUintegerChecker<bool> ())
+    .AddAttribute ("ReactiveJammerActivityHopping",
+                   "Reactive jammer activity hopping flag, set to hop to the channels where"
+                   " traffic was last seen instead of the next channel.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&ReactiveJammer::SetActivityHopping,
+                                         &ReactiveJammer::GetActivityHopping),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("ReactiveJammerCounterRng",
+                   "Reactive jammer counter-based RNG flag, set to draw decisions from"
+                   " a stream keyed by seed, run, jammer id and RNG stream.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&ReactiveJammer::SetCounterRng,
+                                         &ReactiveJammer::GetCounterRng),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("ReactiveJammerRngStream",
+                   "Reactive jammer counter-based RNG stream number.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ReactiveJammer::SetRngStream,
+                                         &ReactiveJammer::GetRngStream),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ReactiveJammerSkipSampling",
+                   "Reactive jammer skip sampling flag, set to draw the number of"
+                   " packets to let pass instead of one decision per packet.",
+                   UintegerValue (false),
+                   MakeUintegerAccessor (&ReactiveJammer::SetSkipSampling,
+                                         &ReactiveJammer::GetSkipSampling),
+                   MakeUintegerChecker<bool> ())
+    .AddAttribute ("ReactiveJammerEnergySamplingPeriod",
+                   "Longest time the energy-aware reactive jammer reuses an energy"
+                   " fraction, 0 to read it on every packet.",
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&ReactiveJammer::SetEnergySamplingPeriod,
+                                     &ReactiveJammer::GetEnergySamplingPeriod),
+                   MakeTimeChecker ())
+    .AddAttribute ("ReactiveJammerEnergyTolerance",
+                   "Largest drift of the cached energy fraction, shortens the energy"
+                   " sampling period when the fraction drains fast.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&ReactiveJammer::SetEnergyTolerance,
+                                       &ReactiveJammer::GetEnergyTolerance),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 ReactiveJammer::ReactiveJammer ()
   : m_random (0.0, 1.0),
-    m_reactToMitigation (false)
+    m_counterRng (false),
+    m_rngKeyed (false),
+    m_rngStream (0),
+    m_skipSampling (false),
+    m_skipCount (0),
+    m_skipProbability (-1.0),
+    m_energyTolerance (0.01),
+    m_energySampled (false),
+    m_energyFraction (0.0)
 {
 }
 
@@ -212,6 +264,112 @@ ReactiveJammer::GetReactToMitigation (void) const
   return m_reactToMitigation;
 }
 
+void
+ReactiveJammer::SetActivityHopping (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_hopPolicy.SetEnabled (flag);
+}
+
+bool
+ReactiveJammer::GetActivityHopping (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_hopPolicy.IsEnabled ();
+}
+
+void
+ReactiveJammer::SetCounterRng (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_counterRng = flag;
+}
+
+bool
+ReactiveJammer::GetCounterRng (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_counterRng;
+}
+
+void
+ReactiveJammer::SetRngStream (uint32_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rngStream = stream;
+  m_rngKeyed = false; // restart the stream on next draw
+}
+
+uint32_t
+ReactiveJammer::GetRngStream (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_rngStream;
+}
+
+void
+ReactiveJammer::SetSkipSampling (const bool flag)
+{
+  NS_LOG_FUNCTION (this << flag);
+  m_skipSampling = flag;
+  m_skipProbability = -1.0; // draw a fresh skip on next packet
+}
+
+bool
+ReactiveJammer::GetSkipSampling (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_skipSampling;
+}
+
+void
+ReactiveJammer::SetEnergySamplingPeriod (Time period)
+{
+  NS_LOG_FUNCTION (this << period);
+  NS_ASSERT (period.GetSeconds () >= 0);
+  m_energySamplingPeriod = period;
+  m_energySampled = false;
+}
+
+Time
+ReactiveJammer::GetEnergySamplingPeriod (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_energySamplingPeriod;
+}
+
+void
+ReactiveJammer::SetEnergyTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  NS_ASSERT (tolerance > 0);
+  m_energyTolerance = tolerance;
+}
+
+double
+ReactiveJammer::GetEnergyTolerance (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_energyTolerance;
+}
+
+JammerStats
+ReactiveJammer::GetStats (void) const
+{
+  NS_LOG_FUNCTION (this);
+  JammerStats stats = m_stats;
+  stats.node = GetId ();
+  stats.jammerType = REACTIVE_JAMMER;
+  return stats;
+}
+
+void
+ReactiveJammer::ResetStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stats.Reset ();
+}
+
 /*
  * Private functions start here.
  */
@@ -220,14 +378,14 @@ void
 ReactiveJammer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
 ReactiveJammer::DoStopJammer (void)
 {
   NS_LOG_FUNCTION (this);
-  m_jammingEvent.Cancel ();
+  m_stats.Cancel (m_jammingEvent);
 }
 
 void
@@ -237,54 +395,26 @@ ReactiveJammer::DoJamming (void)
   NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
                 ", Started!");
 
-  if (m_reactToMitigation)
-    {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", After jammer starts, scheduling RX timeout!");
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &ReactiveJammer::RxTimeoutHandler,
-                                              this);
-    }
+  StartRxTimeout ();
 }
 
 bool
 ReactiveJammer::DoStartRxHandler (Ptr<Packet> packet, double startRss)
 {
   NS_LOG_FUNCTION (this << packet << startRss);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Started receiving a packet!");
+  JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_RX_START, GetId (), 0, startRss);
 
   if (IsPacketToBeJammed (packet))
     {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", Decided to jam this packet!");
-      m_jammingEvent.Cancel (); // cancel previously scheduled event
+      m_stats.Cancel (m_jammingEvent); // cancel previously scheduled event
       // react to packet
       m_jammingEvent = Simulator::Schedule (m_rxTxSwitchingDelay,
                                             &ReactiveJammer::ReactToPacket,
                                             this);
-    }
-  else
-    {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", Decided NOT to jam this packet!");
+      m_stats.eventsScheduled++;
     }
 
-  if (m_reactToMitigation)
-    {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", React to mitigation enabled! Rescheduling RX Timeout");
-      m_rxTimeoutEvent.Cancel (); // cancel RX timeout event
-      // reschedule next RX timeout
-      m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                              &ReactiveJammer::RxTimeoutHandler,
-                                              this);
-    }
-  else
-    {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", React to mitigation disabled!");
-    }
+  NotifyRxActivity ();
 
   return false; // Reactive Jammer always ignores incoming packets
 }
@@ -293,8 +423,7 @@ bool
 ReactiveJammer::DoEndRxHandler (Ptr<Packet> packet, double averageRss)
 {
   NS_LOG_FUNCTION (this << packet << averageRss);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Ignoring incoming packet!");
+  JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_RX_END, GetId (), 0, averageRss);
   return false;
 }
 
@@ -302,95 +431,161 @@ void
 ReactiveJammer::DoEndTxHandler(Ptr<Packet> packet, double txPower)
 {
   NS_LOG_FUNCTION (this << packet << txPower);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Done sending jamming signal with power = " << txPower);
+  JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_BURST_END, GetId (), 0, txPower);
 }
 
 bool
 ReactiveJammer::IsPacketToBeJammed (Ptr<Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Deciding whether to react to packet!");
 
-  double energyFraction;
+  double probability;
   switch (m_reactionStrategy)
     {
     case ENERGY_AWARE:
-      energyFraction = m_source->GetEnergyFraction ();
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", Energy fraction = " << energyFraction);
       // make probabilistic decision based on energy fraction
-      return (m_random.GetValue() < energyFraction);
+      probability = GetEnergyFraction ();
+      break;
     case FIXED_PROBABILITY:
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", Fixed probability " << m_fixedProbability);
       // make probabilistic decision based on fixed probability
-      return (m_random.GetValue () < m_fixedProbability);
+      probability = m_fixedProbability;
+      break;
     default:
       NS_FATAL_ERROR ("ReactiveJammer:At Node #" << GetId () <<
                       ", Error! Unknown strategy of reaction.");
-      break;
+      return false;
     }
-  return false;
+  bool jam = m_skipSampling ? IsPacketSkipSampled (probability)
+    : DrawUniform () < probability;
+  if (jam)
+    {
+      m_stats.decisionsJam++;
+    }
+  else
+    {
+      m_stats.decisionsSkip++;
+    }
+  JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_JAM_DECISION, GetId (), jam,
+                probability);
+  return jam;
 }
 
 void
 ReactiveJammer::ReactToPacket (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Sending jamming signal with power = " << m_txPower << " W");
 
   // send jamming signal
   double actualPower = m_utility->SendJammingSignal (m_txPower, m_jammingDuration);
   if (actualPower != 0.0)
     {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", Jamming signal sent with power = " << actualPower << " W");
+      m_stats.burstsSent++;
+      m_stats.energy += actualPower * m_jammingDuration.GetSeconds ();
+      JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_BURST_SENT, GetId (), 0,
+                    actualPower);
     }
   else
     {
+      JAMMER_TRACE (REACTIVE_JAMMER, JAMMER_TRACE_BURST_FAILED, GetId (), 0,
+                    m_txPower);
+      m_stats.burstsFailed++;
       NS_LOG_ERROR ("ReactiveJammer:At Node #" << GetId () <<
                     ", Failed to send jamming signal!");
     }
 }
 
-void
-ReactiveJammer::RxTimeoutHandler (void)
+double
+ReactiveJammer::DrawUniform (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () << ", RX timeout at " <<
-                Simulator::Now ().GetSeconds () << "s");
-  NS_ASSERT (m_utility != NULL);
+  if (!m_counterRng)
+    {
+      return m_random.GetValue ();
+    }
+  if (!m_rngKeyed)
+    {
+      // keyed on first draw, once the jammer id is known
+      m_rng.SetStream (GetId (), m_rngStream);
+      m_rngKeyed = true;
+    }
+  return m_rng.GetValue ();
+}
 
-  m_rxTimeoutEvent.Cancel (); // cancel previously scheduled RX timeout
+bool
+ReactiveJammer::IsPacketSkipSampled (double probability)
+{
+  NS_LOG_FUNCTION (this << probability);
+  if (m_skipProbability < 0 || probability > m_skipProbability)
+    {
+      // no skip yet, or the probability rose above its bound; skips are
+      // memoryless, so redrawing from this packet is exact
+      DrawSkipCount (probability);
+    }
+  if (m_skipCount > 0)
+    {
+      m_skipCount--;
+      return false;
+    }
+  // candidate packet, thinned down to the current probability
+  bool jam = probability >= m_skipProbability ||
+    DrawUniform () * m_skipProbability < probability;
+  DrawSkipCount (probability);
+  return jam;
+}
 
-  if (!m_reactToMitigation)
+void
+ReactiveJammer::DrawSkipCount (double probability)
+{
+  NS_LOG_FUNCTION (this << probability);
+  m_skipProbability = probability;
+  if (probability >= 1.0)
     {
-      NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                    ", React to mitigation is turned OFF!");
+      m_skipCount = 0;
       return;
     }
-
-  // calculate channel number
-  uint16_t currentChannel = m_utility->GetPhyLayerInfo ().currentChannel;
-  uint16_t nextChannel = currentChannel + 1;
-  if (nextChannel >= m_utility->GetPhyLayerInfo ().numOfChannels)
+  if (probability <= 0.0)
     {
-      nextChannel = 1;  // wrap around and start form 1
+      m_skipCount = std::numeric_limits<uint64_t>::max ();
+      return;
     }
+  // number of failures before the first success, by inversion
+  double count = std::floor (std::log (1.0 - DrawUniform ()) /
+                             std::log (1.0 - probability));
+  m_skipCount = count < 1.8e19 ? uint64_t (count)
+    : std::numeric_limits<uint64_t>::max ();
+}
 
-  NS_LOG_DEBUG ("ReactiveJammer:At Node #" << GetId () <<
-                ", Switching from channel " << currentChannel << " >-> " <<
-                nextChannel);
-
-  m_utility->SwitchChannel (nextChannel); // hop to next channel
+double
+ReactiveJammer::GetEnergyFraction (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_energySamplingPeriod.IsZero ())
+    {
+      return m_source->GetEnergyFraction ();
+    }
+  Time now = Simulator::Now ();
+  if (m_energySampled && now < m_nextEnergySample)
+    {
+      return m_energyFraction;
+    }
 
-  // schedule next RX timeout
-  m_rxTimeoutEvent = Simulator::Schedule (m_rxTimeout,
-                                          &ReactiveJammer::RxTimeoutHandler,
-                                          this);
+  double fraction = m_source->GetEnergyFraction ();
+  Time wait = m_energySamplingPeriod;
+  if (m_energySampled && m_energySampleTime < now)
+    {
+      // drain rate since the last read; keep the next drift within tolerance
+      double rate = std::fabs (fraction - m_energyFraction) /
+        (now - m_energySampleTime).GetSeconds ();
+      if (rate * wait.GetSeconds () > m_energyTolerance)
+        {
+          wait = Seconds (m_energyTolerance / rate);
+        }
+    }
+  m_energySampled = true;
+  m_energyFraction = fraction;
+  m_energySampleTime = now;
+  m_nextEnergySample = now + wait;
+  return fraction;
 }
 
 } // namespace ns3
@@ -22,6 +22,10 @@
 #define REACTIVE_JAMMER_H
 
 #include "jammer.h"
+#include "jammer-stats.h"
+#include "jammer-mitigation.h"
+#include "channel-activity-hop-policy.h"
+#include "philox-random-stream.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 
@@ -30,9 +34,11 @@ namespace ns3 {
 /**
  * Reactive Jammer.
  */
-class ReactiveJammer : public Jammer
+class ReactiveJammer : public Jammer, public JammerMitigation<ReactiveJammer, ChannelActivityHopPolicy>
 {
 public:
+  static const JammerType JAMMER_TYPE = REACTIVE_JAMMER;
+
   /**
    * Available reaction strategies for reactive jammer.
    */
@@ -76,9 +82,63 @@ public:
   Time GetRxTimeout (void) const;
   void SetReactToMitigation (const bool flag);
   bool GetReactToMitigation (void) const;
+  /**
+   * \brief Enables activity-based channel hopping.
+   *
+   * \param flag True to hop to the channels where traffic was last seen, see
+   * ChannelActivityHopPolicy, instead of stepping to the next channel.
+   */
+  void SetActivityHopping (const bool flag);
+  bool GetActivityHopping (void) const;
+  /**
+   * \brief Draws reaction decisions from a counter-based stream keyed by the
+   * simulation seed and run, the jammer id and the RNG stream number.
+   *
+   * \param flag True to use the counter-based stream.
+   */
+  void SetCounterRng (const bool flag);
+  bool GetCounterRng (void) const;
+  void SetRngStream (uint32_t stream);
+  uint32_t GetRngStream (void) const;
+  /**
+   * \brief Enables skip sampling of reaction decisions.
+   *
+   * \param flag True to draw, once per jammed packet, how many packets to let
+   * pass before the next one to jam (geometric distribution), instead of one
+   * random draw per packet.
+   *
+   * For ENERGY_AWARE the skip is drawn with the energy fraction at the time
+   * of the draw as an upper bound, and the packet it lands on is jammed with
+   * probability (current fraction / bound). If the fraction rises above the
+   * bound, the skip is redrawn. Each packet is still jammed with the current
+   * probability.
+   */
+  void SetSkipSampling (const bool flag);
+  bool GetSkipSampling (void) const;
+  /**
+   * \brief Sets how long the ENERGY_AWARE strategy reuses an energy fraction
+   * read from the energy source.
+   *
+   * \param period Longest time between two reads, 0 to read on every packet.
+   *
+   * The period is shortened when the fraction drains fast, so that the cached
+   * value stays within the energy fraction tolerance of the source.
+   */
+  void SetEnergySamplingPeriod (Time period);
+  Time GetEnergySamplingPeriod (void) const;
+  void SetEnergyTolerance (double tolerance);
+  double GetEnergyTolerance (void) const;
+
+  /**
+   * \returns Work counters of this jammer since start or the last reset.
+   */
+  JammerStats GetStats (void) const;
+  void ResetStats (void);
 
 
 private:
+  friend class JammerMitigation<ReactiveJammer, ChannelActivityHopPolicy>;
+
   void DoDispose (void);
 
   /**
@@ -136,9 +196,31 @@ private:
   void ReactToPacket (void);
 
   /**
-   * Handles RX timeout event by hopping onto next channel.
+   * \returns Uniform random value in [0, 1) for reaction decisions.
+   */
+  double DrawUniform (void);
+
+  /**
+   * \returns Energy fraction of the source, cached for at most the energy
+   * sampling period.
+   */
+  double GetEnergyFraction (void);
+
+  /**
+   * \brief Decides whether to jam a packet by skip sampling.
+   *
+   * \param probability Current probability of jamming a packet.
+   * \returns True if current packet is to be jammed.
+   */
+  bool IsPacketSkipSampled (double probability);
+
+  /**
+   * \brief Draws the number of packets to let pass before the next candidate
+   * packet.
+   *
+   * \param probability Upper bound of the probability of jamming a packet.
    */
-  void RxTimeoutHandler (void);
+  void DrawSkipCount (double probability);
 
 private:
   Ptr<WirelessModuleUtility> m_utility;
@@ -150,9 +232,20 @@ private:
   ReactionStrategy m_reactionStrategy; // Reaction strategy used by the jammer.
   double m_fixedProbability;	// Used for FIXED_PROBABILITY reaction strategy
   UniformVariable m_random;	  // Used for making probabilistic decisions for reacting to a packet
-  Time m_rxTimeout;           // RX timeout interval
-  EventId m_rxTimeoutEvent;   // RX timeout event
-  bool m_reactToMitigation;   // true if jammer is reacting to mitigation
+  bool m_counterRng;          // true to draw decisions from m_rng
+  PhiloxRandomStream m_rng;   // counter-based decision stream
+  bool m_rngKeyed;            // true once m_rng is keyed for this jammer
+  uint32_t m_rngStream;       // stream number within the jammer
+  bool m_skipSampling;        // true to skip sample reaction decisions
+  uint64_t m_skipCount;       // packets left to pass before next candidate
+  double m_skipProbability;   // bound the skip was drawn with, < 0 if none
+  Time m_energySamplingPeriod;  // longest reuse of a cached energy fraction
+  double m_energyTolerance;   // largest expected drift of cached fraction
+  bool m_energySampled;       // true once m_energyFraction has been read
+  double m_energyFraction;    // cached energy fraction
+  Time m_energySampleTime;    // time m_energyFraction was read
+  Time m_nextEnergySample;    // time the cached fraction expires
+  JammerStats m_stats;        // work counters
 
 };
 
@@ -0,0 +1,132 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "training-columns.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+const uint32_t TrainingColumns::FEATURES;
+
+TrainingColumns::TrainingColumns (const std::vector<JammingSample> &samples)
+  : m_classes (0)
+{
+  m_labels.resize (samples.size ());
+  m_values[0].resize (samples.size ());
+  m_values[1].resize (samples.size ());
+  for (uint32_t i = 0; i < samples.size (); i++)
+    {
+      m_labels[i] = samples[i].label;
+      m_classes = std::max<uint32_t> (m_classes, samples[i].label + 1);
+      m_values[0][i] = static_cast<float> (samples[i].feature.rss);
+      m_values[1][i] = static_cast<float> (samples[i].feature.pdr);
+    }
+  for (uint32_t f = 0; f < FEATURES; f++)
+    {
+      std::vector<std::pair<float, uint32_t> > keyed (samples.size ());
+      for (uint32_t i = 0; i < samples.size (); i++)
+        {
+          keyed[i] = std::make_pair (m_values[f][i], i);
+        }
+      std::sort (keyed.begin (), keyed.end ());
+      m_sorted[f].resize (samples.size ());
+      for (uint32_t i = 0; i < samples.size (); i++)
+        {
+          m_sorted[f][i] = keyed[i].second;
+        }
+    }
+}
+
+uint32_t
+TrainingColumns::GetSampleCount (void) const
+{
+  return m_labels.size ();
+}
+
+uint32_t
+TrainingColumns::GetClassCount (void) const
+{
+  return m_classes;
+}
+
+const std::vector<float> &
+TrainingColumns::GetValues (uint32_t feature) const
+{
+  return m_values[feature];
+}
+
+const std::vector<uint32_t> &
+TrainingColumns::GetSorted (uint32_t feature) const
+{
+  return m_sorted[feature];
+}
+
+const std::vector<uint8_t> &
+TrainingColumns::GetLabels (void) const
+{
+  return m_labels;
+}
+
+void
+TrainingColumns::Partition (std::vector<uint32_t> order[FEATURES],
+                            uint32_t feature, uint32_t begin, uint32_t split,
+                            uint32_t end, std::vector<uint8_t> &goesLeft,
+                            std::vector<uint32_t> &buffer)
+{
+  for (uint32_t p = begin; p < end; p++)
+    {
+      goesLeft[order[feature][p]] = p < split;
+    }
+  for (uint32_t f = 0; f < FEATURES; f++)
+    {
+      if (f == feature)
+        {
+          continue; // already split at split
+        }
+      uint32_t left = begin;
+      uint32_t rights = 0;
+      for (uint32_t p = begin; p < end; p++)
+        {
+          uint32_t sample = order[f][p];
+          if (goesLeft[sample])
+            {
+              order[f][left++] = sample;
+            }
+          else
+            {
+              buffer[rights++] = sample;
+            }
+        }
+      std::copy (buffer.begin (), buffer.begin () + rights,
+                 order[f].begin () + left);
+    }
+}
+
+double
+TrainingColumns::Threshold (float value, float nextValue)
+{
+  double threshold = value / 2.0 + nextValue / 2.0;
+  if (threshold == nextValue ||
+      std::fabs (threshold) == std::numeric_limits<double>::infinity ())
+    {
+      threshold = value;
+    }
+  return threshold;
+}
+
+} // namespace ns3
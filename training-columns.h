@@ -0,0 +1,96 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRAINING_COLUMNS_H
+#define TRAINING_COLUMNS_H
+
+#include "jamming-dataset.h"
+#include "ns3/simple-ref-count.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Training set as presorted float feature columns, shared by the
+ * tree trainers.
+ *
+ * Sorting the columns is the only superlinear step of growing a tree, so
+ * one TrainingColumns can be handed to any number of trainers, e.g. every
+ * candidate of a hyperparameter search. A tree keeps its own copy of the
+ * sorted lists, restricted to its samples, and Partition splits a node's
+ * range of them in place, preserving the order.
+ */
+class TrainingColumns : public SimpleRefCount<TrainingColumns>
+{
+public:
+  static const uint32_t FEATURES = 2;
+
+  /**
+   * \param samples Scaled samples; labels are the class indices.
+   */
+  TrainingColumns (const std::vector<JammingSample> &samples);
+
+  uint32_t GetSampleCount (void) const;
+
+  /**
+   * \returns Highest label + 1.
+   */
+  uint32_t GetClassCount (void) const;
+
+  /**
+   * \returns Features of a column as float, as sklearn trains on them.
+   */
+  const std::vector<float> &GetValues (uint32_t feature) const;
+
+  /**
+   * \returns Sample indices, by increasing value of a feature.
+   */
+  const std::vector<uint32_t> &GetSorted (uint32_t feature) const;
+
+  const std::vector<uint8_t> &GetLabels (void) const;
+
+  /**
+   * \brief Splits a node after samples order[feature][begin, split) were
+   * sent left.
+   *
+   * The node's range of the other sorted lists is stably partitioned into
+   * left samples, then right samples.
+   *
+   * \param order Per-tree sorted lists.
+   * \param goesLeft Scratch, one entry per sample.
+   * \param buffer Scratch, at least end - begin entries.
+   */
+  static void Partition (std::vector<uint32_t> order[FEATURES],
+                         uint32_t feature, uint32_t begin, uint32_t split,
+                         uint32_t end, std::vector<uint8_t> &goesLeft,
+                         std::vector<uint32_t> &buffer);
+
+  /**
+   * \returns sklearn's threshold between two adjacent feature values, the
+   * midpoint unless it rounds to the upper value.
+   */
+  static double Threshold (float value, float nextValue);
+
+private:
+  uint32_t m_classes;
+  std::vector<uint8_t> m_labels;
+  std::vector<float> m_values[FEATURES];
+  std::vector<uint32_t> m_sorted[FEATURES];
+};
+
+} // namespace ns3
+
+#endif /* TRAINING_COLUMNS_H */
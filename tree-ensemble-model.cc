@@ -0,0 +1,320 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tree-ensemble-model.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+
+namespace ns3 {
+
+float
+FloatThresholdBelow (double value)
+{
+  float result = static_cast<float> (value);
+  if (static_cast<double> (result) > value)
+    {
+      result = nextafterf (result, -std::numeric_limits<float>::infinity ());
+    }
+  return result;
+}
+
+uint32_t
+DecisionTree::GetDepth (void) const
+{
+  // children always come after their parent, so one forward pass works
+  std::vector<uint32_t> depth (nodes.size (), 0);
+  uint32_t maxDepth = 0;
+  for (uint32_t i = 0; i < nodes.size (); i++)
+    {
+      if (nodes[i].feature < 0)
+        {
+          continue;
+        }
+      depth[nodes[i].left] = depth[i] + 1;
+      depth[nodes[i].right] = depth[i] + 1;
+      maxDepth = depth[i] + 1 > maxDepth ? depth[i] + 1 : maxDepth;
+    }
+  return maxDepth;
+}
+
+TreeEnsembleModel::TreeEnsembleModel ()
+  : kind ("forest"),
+    classes (0),
+    features (0),
+    outputs (0)
+{
+}
+
+uint32_t
+TreeEnsembleModel::GetScoreCount (void) const
+{
+  return classes == 2 ? 1 : classes;
+}
+
+bool
+TreeEnsembleModel::Load (std::string const &filename, std::string &error)
+{
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      error = "cannot open " + filename;
+      return false;
+    }
+
+  std::string word;
+  uint32_t version, numTrees;
+  if (!(file >> word >> version) || word != "jamming-model" || version != 1)
+    {
+      error = "not a version 1 jamming model";
+      return false;
+    }
+  std::string classesKey, featuresKey, outputsKey, treesKey, kindKey;
+  if (!(file >> kindKey >> kind >> classesKey >> classes >> featuresKey >>
+        features >> outputsKey >> outputs >> treesKey >> numTrees) ||
+      kindKey != "kind" || classesKey != "classes" ||
+      featuresKey != "features" || outputsKey != "outputs" ||
+      treesKey != "trees")
+    {
+      error = "malformed model header";
+      return false;
+    }
+
+  init.clear ();
+  if (kind == "boosting")
+    {
+      init.resize (GetScoreCount ());
+      bool ok = (file >> word) && word == "init";
+      for (uint32_t k = 0; ok && k < init.size (); k++)
+        {
+          ok = static_cast<bool> (file >> init[k]);
+        }
+      if (!ok)
+        {
+          error = "malformed init scores";
+          return false;
+        }
+    }
+
+  trees.assign (numTrees, DecisionTree ());
+  for (uint32_t t = 0; t < numTrees; t++)
+    {
+      uint32_t index, numNodes;
+      if (!(file >> word >> index >> numNodes) || word != "tree" ||
+          index != t || numNodes == 0)
+        {
+          std::ostringstream os;
+          os << "malformed header of tree " << t;
+          error = os.str ();
+          return false;
+        }
+      DecisionTree &tree = trees[t];
+      tree.nodes.resize (numNodes);
+      tree.values.assign (numNodes * outputs, 0.0);
+      for (uint32_t n = 0; n < numNodes; n++)
+        {
+          TreeNode &node = tree.nodes[n];
+          bool ok = static_cast<bool> (file >> node.feature);
+          if (ok && node.feature < 0)
+            {
+              node.feature = -1;
+              node.threshold = 0.0;
+              node.left = node.right = -1;
+              for (uint32_t v = 0; ok && v < outputs; v++)
+                {
+                  ok = static_cast<bool> (file >> tree.values[n * outputs + v]);
+                }
+            }
+          else if (ok)
+            {
+              ok = static_cast<bool> (file >> node.threshold >> node.left >>
+                                      node.right);
+            }
+          if (!ok)
+            {
+              std::ostringstream os;
+              os << "malformed node " << n << " of tree " << t;
+              error = os.str ();
+              return false;
+            }
+        }
+    }
+  return Validate (error);
+}
+
+void
+TreeEnsembleModel::Write (std::ostream &os) const
+{
+  std::ios::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::setprecision (std::numeric_limits<double>::digits10 + 2);
+  os << "jamming-model 1\n"
+     << "kind " << kind << "\n"
+     << "classes " << classes << "\n"
+     << "features " << features << "\n"
+     << "outputs " << outputs << "\n"
+     << "trees " << trees.size () << "\n";
+  if (kind == "boosting")
+    {
+      os << "init";
+      for (uint32_t k = 0; k < init.size (); k++)
+        {
+          os << " " << init[k];
+        }
+      os << "\n";
+    }
+  for (uint32_t t = 0; t < trees.size (); t++)
+    {
+      const DecisionTree &tree = trees[t];
+      os << "tree " << t << " " << tree.nodes.size () << "\n";
+      for (uint32_t n = 0; n < tree.nodes.size (); n++)
+        {
+          const TreeNode &node = tree.nodes[n];
+          if (node.feature < 0)
+            {
+              os << -1;
+              for (uint32_t v = 0; v < outputs; v++)
+                {
+                  os << " " << tree.values[n * outputs + v];
+                }
+            }
+          else
+            {
+              os << node.feature << " " << node.threshold << " " << node.left
+                 << " " << node.right;
+            }
+          os << "\n";
+        }
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+bool
+TreeEnsembleModel::Validate (std::string &error) const
+{
+  if (classes == 0 || features == 0 || outputs == 0 || trees.empty ())
+    {
+      error = "model has no classes, features, outputs or trees";
+      return false;
+    }
+  if (kind == "boosting" &&
+      (classes < 2 || outputs != 1 || init.size () != GetScoreCount () ||
+       trees.size () % GetScoreCount () != 0))
+    {
+      error = "boosting model needs one output per tree, init scores and"
+        " whole stages";
+      return false;
+    }
+  if (kind != "forest" && kind != "boosting")
+    {
+      error = "unknown model kind " + kind;
+      return false;
+    }
+  for (uint32_t t = 0; t < trees.size (); t++)
+    {
+      const DecisionTree &tree = trees[t];
+      if (tree.values.size () != tree.nodes.size () * outputs)
+        {
+          error = "leaf values do not match number of nodes";
+          return false;
+        }
+      for (uint32_t n = 0; n < tree.nodes.size (); n++)
+        {
+          const TreeNode &node = tree.nodes[n];
+          if (node.feature < 0)
+            {
+              continue;
+            }
+          // children must come after the parent, which also rules out cycles
+          if (uint32_t (node.feature) >= features ||
+              node.left <= int32_t (n) || node.right <= int32_t (n) ||
+              node.left >= int32_t (tree.nodes.size ()) ||
+              node.right >= int32_t (tree.nodes.size ()))
+            {
+              std::ostringstream os;
+              os << "bad feature or child index at node " << n << " of tree "
+                 << t;
+              error = os.str ();
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+uint32_t
+TreeEnsembleModel::Predict (const double *x) const
+{
+  uint32_t scores = kind == "boosting" ? GetScoreCount () : outputs;
+  std::vector<double> sum (scores, 0.0);
+  if (kind == "boosting")
+    {
+      sum = init;
+    }
+  for (uint32_t t = 0; t < trees.size (); t++)
+    {
+      const DecisionTree &tree = trees[t];
+      int32_t n = 0;
+      while (tree.nodes[n].feature >= 0)
+        {
+          const TreeNode &node = tree.nodes[n];
+          float value = static_cast<float> (x[node.feature]);
+          n = value <= node.threshold ? node.left : node.right;
+        }
+      const double *value = &tree.values[n * outputs];
+      if (kind == "boosting")
+        {
+          sum[t % scores] += value[0];
+          continue;
+        }
+      // normalize as sklearn's predict_proba does
+      double total = 0.0;
+      for (uint32_t c = 0; c < outputs; c++)
+        {
+          total += value[c];
+        }
+      total = total == 0.0 ? 1.0 : total;
+      for (uint32_t c = 0; c < outputs; c++)
+        {
+          sum[c] += value[c] / total;
+        }
+    }
+  if (kind == "forest")
+    {
+      for (uint32_t c = 0; c < scores; c++)
+        {
+          sum[c] /= trees.size (); // mean, as RandomForestClassifier
+        }
+    }
+  if (scores == 1)
+    {
+      return sum[0] > 0.0 ? 1 : 0;
+    }
+  uint32_t best = 0;
+  for (uint32_t c = 1; c < scores; c++)
+    {
+      if (sum[c] > sum[best])
+        {
+          best = c;
+        }
+    }
+  return best;
+}
+
+} // namespace ns3
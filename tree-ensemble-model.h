@@ -0,0 +1,148 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TREE_ENSEMBLE_MODEL_H
+#define TREE_ENSEMBLE_MODEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * One node of a decision tree. Samples with x[feature] <= threshold go to
+ * the left child, as in sklearn.
+ */
+struct TreeNode
+{
+  int32_t feature;      // feature index, -1 for a leaf
+  double threshold;
+  int32_t left;         // index of left child within the tree
+  int32_t right;        // index of right child within the tree
+};
+
+/**
+ * \brief Rounds a split threshold to float, as features are compared.
+ *
+ * \returns Largest float not greater than value. For any float x,
+ * x <= result exactly when x <= value, so comparing a float feature with
+ * the result gives sklearn's decision. Used by every evaluator that stores
+ * float thresholds, so they all agree.
+ */
+float FloatThresholdBelow (double value);
+
+/**
+ * A decision tree. Leaf values are stored row-wise, "outputs" values per
+ * node (the rows of internal nodes are unused).
+ */
+struct DecisionTree
+{
+  std::vector<TreeNode> nodes;
+  std::vector<double> values;
+
+  /**
+   * \returns Depth of the tree, 0 for a single leaf.
+   */
+  uint32_t GetDepth (void) const;
+};
+
+/**
+ * \brief Tree ensemble exported from sklearn or written by the native
+ * trainer.
+ *
+ * For kind "forest" each leaf holds the class probabilities of the
+ * samples that reached it. The prediction is the argmax of the mean over
+ * trees, as for sklearn's RandomForestClassifier. A DecisionTreeClassifier
+ * is a forest of one tree.
+ *
+ * For kind "boosting" (sklearn's GradientBoostingClassifier) every tree has
+ * one output, its leaf values already scaled by the learning rate. Trees
+ * are listed stage by stage, one per score (a single score for two
+ * classes, else one per class), so tree t adds to score t % scores. Scores
+ * start from the "init" values. The prediction is the argmax of the scores,
+ * or class 1 if the single score is positive.
+ *
+ * Text file layout:
+ *
+ *   jamming-model 1
+ *   kind forest
+ *   classes 4
+ *   features 2
+ *   outputs 4
+ *   trees T
+ *   init <score 0> ... <score scores-1>        (boosting only)
+ *   tree <index> <number of nodes>
+ *   <feature> <threshold> <left> <right>        (internal node)
+ *   -1 <value 0> ... <value outputs-1>          (leaf)
+ *   ...
+ *
+ * Nodes of a tree are listed in index order. Thresholds are written with
+ * enough digits to round trip exactly.
+ */
+struct TreeEnsembleModel
+{
+  std::string kind;
+  uint32_t classes;
+  uint32_t features;
+  uint32_t outputs;     // values per leaf
+  std::vector<DecisionTree> trees;
+  std::vector<double> init;     // initial scores, boosting only
+
+  TreeEnsembleModel ();
+
+  /**
+   * \returns Number of scores of a boosting model, 1 for two classes and
+   * one per class otherwise.
+   */
+  uint32_t GetScoreCount (void) const;
+
+  /**
+   * \brief Loads a model file.
+   *
+   * \param filename Name of the file.
+   * \param error Set to a description of the problem on failure.
+   * \returns False if the file cannot be read or is malformed.
+   */
+  bool Load (std::string const &filename, std::string &error);
+
+  /**
+   * \brief Writes the model in the text layout above.
+   */
+  void Write (std::ostream &os) const;
+
+  /**
+   * \brief Checks child indices and leaf values of all trees.
+   *
+   * \returns False and sets error if the model is inconsistent.
+   */
+  bool Validate (std::string &error) const;
+
+  /**
+   * \brief Reference prediction, walking every tree node by node.
+   *
+   * Features are compared as floats, as sklearn does.
+   *
+   * \param x Feature values.
+   * \returns Predicted class.
+   */
+  uint32_t Predict (const double *x) const;
+};
+
+} // namespace ns3
+
+#endif /* TREE_ENSEMBLE_MODEL_H */